@@ -0,0 +1,223 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+void usage()
+{
+    printf("Usage: dotGenerator [options]\n");
+    printf(" Writes a random instance in dot format, to measure the parser on inputs of any size.\n");
+    printf("Options:\n");
+    printf(" -h           Displays this help\n");
+    printf(" -P PROBLEM   \"Tunnel\" (a tunnel network: a digraph whose nodes are labelled with actions) or \"Colouring\" (an undirected graph) [default: Tunnel]\n");
+    printf(" -n NODES     The number of nodes [default: 1000]\n");
+    printf(" -d DEGREE    The number of edges leaving each node [default: 3]. The number of edges is NODES * DEGREE.\n");
+    printf(" -a NUM       The number of attributes the solvers do not use (positions, colours...) added to each node and each edge [default: 0]\n");
+    printf(" -s SEED      The seed of the random generator [default: 1]\n");
+    printf(" -o FILE      Writes the instance in FILE [default: the standard output]\n");
+}
+
+/**
+ * @brief State of the random generator (xorshift64*).
+ */
+static uint64_t random_state = 1;
+
+/**
+ * @brief Returns a random number between 0 and @p bound - 1.
+ *
+ * @param bound A positive bound.
+ * @return uint64_t The number.
+ */
+uint64_t random_below(uint64_t bound)
+{
+    random_state ^= random_state >> 12;
+    random_state ^= random_state << 25;
+    random_state ^= random_state >> 27;
+    return ((random_state * 0x2545F4914F6CDD1DULL) >> 11) % bound;
+}
+
+/**
+ * @brief The actions of a tunnel network, as written in labels.
+ */
+static const char *actions[] = {"4→4", "6→6", "4↑44", "4↑46", "6↑64", "6↑66", "44↓4", "46↓4", "64↓6", "66↓6"};
+
+/**
+ * @brief Writes @p num_attributes random attributes, as graphviz exports contain.
+ *
+ * @param file The output.
+ * @param num_attributes Their number.
+ * @param edge Whether the attributes are those of an edge.
+ */
+void write_unused_attributes(FILE *file, int num_attributes, int edge)
+{
+    // The first four attributes have the usual names, the next ones are numbered (%.0d writes nothing for 0).
+    for (int attribute = 0; attribute < num_attributes; attribute++)
+    {
+        int round = attribute / 4;
+        switch (attribute % 4)
+        {
+        case 0:
+            if (edge)
+                fprintf(file, ", pos%.0d=\"e,%.3f,%.3f %.3f,%.3f\"", round, random_below(100000) / 100.0, random_below(100000) / 100.0, random_below(100000) / 100.0, random_below(100000) / 100.0);
+            else
+                fprintf(file, ", pos%.0d=\"%.3f,%.3f\"", round, random_below(100000) / 100.0, random_below(100000) / 100.0);
+            break;
+        case 1:
+            fprintf(file, ", color%.0d=\"#%06x\"", round, (unsigned)random_below(1 << 24));
+            break;
+        case 2:
+            fprintf(file, ", %s%.0d=%.4f", edge ? "penwidth" : "width", round, random_below(100000) / 10000.0);
+            break;
+        case 3:
+            fprintf(file, ", fontname%.0d=\"Helvetica\"", round);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Writes a random tunnel network. Node 0 is the initial node and the last node the final one. Each node has an edge to the next one, so that a path goes through all nodes.
+ *
+ * @param file The output.
+ * @param num_nodes The number of nodes.
+ * @param degree The number of edges leaving each node.
+ * @param num_attributes The number of unused attributes of each node and edge.
+ */
+void write_tunnel(FILE *file, long num_nodes, long degree, int num_attributes)
+{
+    fprintf(file, "digraph network {\n");
+    for (long node = 0; node < num_nodes; node++)
+    {
+        fprintf(file, "\t%ld\t[label=\"", node);
+        int num_actions = 1 + random_below(3);
+        for (int action = 0; action < num_actions; action++)
+            fprintf(file, "%s%s", action == 0 ? "" : "\\n", actions[random_below(10)]);
+        fprintf(file, "\"");
+        if (node == 0)
+            fprintf(file, ", shape=square");
+        else if (node == num_nodes - 1)
+            fprintf(file, ", shape=invtriangle");
+        write_unused_attributes(file, num_attributes, 0);
+        fprintf(file, "];\n");
+        for (long edge = 0; edge < degree; edge++)
+        {
+            long target = edge == 0 ? (node + 1) % num_nodes : (long)random_below(num_nodes);
+            fprintf(file, "\t%ld -> %ld", node, target);
+            if (num_attributes > 0)
+            {
+                fprintf(file, "\t[weight=1");
+                write_unused_attributes(file, num_attributes, 1);
+                fprintf(file, "]");
+            }
+            fprintf(file, ";\n");
+        }
+    }
+    fprintf(file, "}\n");
+}
+
+/**
+ * @brief Writes a random undirected graph.
+ *
+ * @param file The output.
+ * @param num_nodes The number of nodes.
+ * @param degree The number of edges written for each node (the edges to the node itself are left out).
+ * @param num_attributes The number of unused attributes of each node and edge.
+ */
+void write_colouring(FILE *file, long num_nodes, long degree, int num_attributes)
+{
+    fprintf(file, "graph G {\n");
+    for (long node = 0; node < num_nodes; node++)
+    {
+        fprintf(file, "%ld", node);
+        if (num_attributes > 0)
+        {
+            fprintf(file, " [style=filled");
+            write_unused_attributes(file, num_attributes, 0);
+            fprintf(file, "]");
+        }
+        fprintf(file, ";\n");
+        for (long edge = 0; edge < degree; edge++)
+        {
+            long target = (long)random_below(num_nodes);
+            if (target == node)
+                continue;
+            fprintf(file, "%ld -- %ld", node, target);
+            if (num_attributes > 0)
+            {
+                fprintf(file, " [weight=1");
+                write_unused_attributes(file, num_attributes, 1);
+                fprintf(file, "]");
+            }
+            fprintf(file, ";\n");
+        }
+    }
+    fprintf(file, "}\n");
+}
+
+int main(int argc, char *argv[])
+{
+    int tunnel = 1;
+    long num_nodes = 1000;
+    long degree = 3;
+    int num_attributes = 0;
+    char *output = NULL;
+    int option;
+
+    while ((option = getopt(argc, argv, "hP:n:d:a:s:o:")) != -1)
+    {
+        switch (option)
+        {
+        case 'h':
+            usage();
+            return EXIT_SUCCESS;
+        case 'P':
+            tunnel = strcmp(optarg, "Colouring") != 0;
+            break;
+        case 'n':
+            num_nodes = atol(optarg);
+            break;
+        case 'd':
+            degree = atol(optarg);
+            break;
+        case 'a':
+            num_attributes = atoi(optarg);
+            break;
+        case 's':
+            random_state = strtoull(optarg, NULL, 10);
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        default:
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+    if (num_nodes < 1 || degree < 0 || num_attributes < 0)
+    {
+        usage();
+        return EXIT_FAILURE;
+    }
+    // xorshift never leaves the state 0.
+    if (random_state == 0)
+        random_state = 1;
+
+    FILE *file = output == NULL ? stdout : fopen(output, "w");
+    if (file == NULL)
+    {
+        printf("Cannot write %s.\n", output);
+        return EXIT_FAILURE;
+    }
+    static char buffer[1 << 20];
+    setvbuf(file, buffer, _IOFBF, sizeof(buffer));
+
+    if (tunnel)
+        write_tunnel(file, num_nodes, degree, num_attributes);
+    else
+        write_colouring(file, num_nodes, degree, num_attributes);
+
+    if (file != stdout)
+        fclose(file);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,187 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <Graph.h>
+#include <Parsing.h>
+#include <Z3Tools.h>
+#include <ColouredGraph.h>
+#include <ColouringReduction.h>
+#include <TunnelNetwork.h>
+#include <TunnelReduction.h>
+
+/**
+ * @brief The encodings compared, and their names.
+ */
+static const atMostOneEncoding encodings[] = {at_most_one_pairwise, at_most_one_sequential, at_most_one_commander, at_most_one_bimander, at_most_one_native};
+static const char *encoding_names[] = {"pairwise", "sequential", "commander", "bimander", "native"};
+#define NUM_ENCODINGS (int)(sizeof(encodings) / sizeof(encodings[0]))
+
+void usage()
+{
+    printf("Usage: encodingBenchmark [-P PROBLEM] [-c VAL] file...\n");
+    printf(" Compares, on each file, the encodings of the \"at most one\" constraints of the reduction (pairwise, sequential, commander, bimander and the native cardinality constraints of Z3).\n");
+    printf(" For each encoding, reports the time spent building the formulae and solving them, and the peak memory of the process.\n");
+    printf(" -P PROBLEM \"Tunnel\" (searches a simple path of each length from 1 to VAL [default: 8]) or \"Colouring\" (searches a colouring with VAL colours [default: 3]) [default: Tunnel]\n");
+    printf(" Compile without -fsanitize=address for meaningful numbers.\n");
+}
+
+/**
+ * @brief Returns the current time in seconds.
+ */
+double now()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief The measures of a run, sent by the process doing it.
+ */
+typedef struct
+{
+    double encode_time; ///< Seconds spent building the formulae.
+    double solve_time;  ///< Seconds spent solving them.
+    int answer;         ///< Tunnel: the smallest length with a path (0 if none). Colouring: 1 if a colouring exists, 0 otherwise.
+    bool decided;       ///< Whether the solver decided every formula.
+} runMeasures;
+
+/**
+ * @brief Solves the problem on a graph with the current encoding.
+ *
+ * @param graph The graph.
+ * @param tunnel Whether the problem is the tunnel network one (colouring otherwise).
+ * @param value The maximal length of paths, or the number of colours.
+ * @return runMeasures The measures.
+ */
+runMeasures run(Graph graph, bool tunnel, int value)
+{
+    runMeasures measures = {0, 0, 0, true};
+    Z3_context ctx = make_context();
+    if (tunnel)
+    {
+        TunnelNetwork network = tn_initialize(graph);
+        VariableTable variables = tn_variable_table_create(ctx, network);
+        // Like the solver, every length is tried in turn, and the first path found ends the search.
+        for (int length = 1; length <= value && measures.answer == 0; length++)
+        {
+            double start = now();
+            Z3_ast formula = tn_reduction(ctx, variables, network, length);
+            measures.encode_time += now() - start;
+            start = now();
+            Z3_lbool result = is_formula_sat(ctx, formula);
+            measures.solve_time += now() - start;
+            measures.decided = measures.decided && result != Z3_L_UNDEF;
+            if (result == Z3_L_TRUE)
+                measures.answer = length;
+        }
+        variable_table_delete(variables);
+        tn_delete(network);
+    }
+    else
+    {
+        ColouredGraph coloured_graph = cg_initialize(graph);
+        VariableTable variables = colouring_variable_table_create(ctx, coloured_graph);
+        double start = now();
+        Z3_ast formula = colouring_reduction(ctx, variables, coloured_graph, value);
+        measures.encode_time = now() - start;
+        start = now();
+        Z3_lbool result = is_formula_sat(ctx, formula);
+        measures.solve_time = now() - start;
+        measures.decided = result != Z3_L_UNDEF;
+        measures.answer = result == Z3_L_TRUE;
+        variable_table_delete(variables);
+        cg_delete(coloured_graph);
+    }
+    Z3_del_context(ctx);
+    return measures;
+}
+
+int main(int argc, char *argv[])
+{
+    bool tunnel = true;
+    int value = 0;
+    int option;
+
+    while ((option = getopt(argc, argv, "hP:c:")) != -1)
+    {
+        switch (option)
+        {
+        case 'h':
+            usage();
+            return EXIT_SUCCESS;
+        case 'P':
+            tunnel = strcmp(optarg, "Colouring") != 0;
+            break;
+        case 'c':
+            value = atoi(optarg);
+            break;
+        default:
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind >= argc)
+    {
+        usage();
+        return EXIT_FAILURE;
+    }
+    if (value <= 0)
+        value = tunnel ? 8 : 3;
+
+    printf("%-12s %10s %12s %12s %12s\n", "encoding", "answer", "encode (ms)", "solve (ms)", "peak (MB)");
+    for (int i = optind; i < argc; i++)
+    {
+        Graph graph;
+        if (!try_get_graph_from_file(argv[i], &graph))
+            continue;
+        printf("%s (%d nodes, %d edges)\n", argv[i], graph.numNodes, graph.numEdges);
+        fflush(stdout);
+
+        // Each encoding runs in a process of its own, so that its peak memory is measured alone.
+        for (int encoding = 0; encoding < NUM_ENCODINGS; encoding++)
+        {
+            int measures_pipe[2];
+            if (pipe(measures_pipe) != 0)
+                break;
+            pid_t child = fork();
+            if (child == 0)
+            {
+                close(measures_pipe[0]);
+                set_at_most_one_encoding(encodings[encoding]);
+                runMeasures measures = run(graph, tunnel, value);
+                bool written = write(measures_pipe[1], &measures, sizeof(measures)) == sizeof(measures);
+                _exit(written ? EXIT_SUCCESS : EXIT_FAILURE);
+            }
+            close(measures_pipe[1]);
+            runMeasures measures;
+            bool received = child > 0 && read(measures_pipe[0], &measures, sizeof(measures)) == sizeof(measures);
+            close(measures_pipe[0]);
+            int status;
+            struct rusage usage;
+            if (child > 0)
+                wait4(child, &status, 0, &usage);
+            if (!received)
+            {
+                printf("  %-12s failed\n", encoding_names[encoding]);
+                continue;
+            }
+
+            char answer[16];
+            if (!measures.decided)
+                snprintf(answer, sizeof(answer), "unknown");
+            else if (tunnel)
+                snprintf(answer, sizeof(answer), measures.answer > 0 ? "path %d" : "no path", measures.answer);
+            else
+                snprintf(answer, sizeof(answer), measures.answer ? "colourable" : "no");
+            printf("  %-10s %10s %12.1f %12.1f %12.1f\n", encoding_names[encoding], answer, measures.encode_time * 1e3, measures.solve_time * 1e3, usage.ru_maxrss / 1024.0);
+            fflush(stdout);
+        }
+        graph_delete(graph);
+    }
+    return EXIT_SUCCESS;
+}
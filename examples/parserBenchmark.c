@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <Graph.h>
+#include <Parsing.h>
+#include <FastParser.h>
+#include <TunnelNetwork.h>
+#include "Parser.h"
+#include "Lexer.h"
+
+/**
+ * @brief Undirected graphs whose bit-packed adjacency (one bit per pair of nodes) would be larger are parsed, but not built.
+ */
+#define MAX_EDGE_BITS ((size_t)1 << 30)
+
+void usage()
+{
+    printf("Usage: parserBenchmark [-n repetitions] file...\n");
+    printf(" Measures separately, on each file, the throughput of the flex scanner alone, of the fast parser, of the flex/bison parser, of the construction of the graph from the parsed statements and of tn_initialize (on directed graphs).\n");
+    printf(" Undirected graphs whose bit-packed adjacency would take more than %zu MB are only parsed. Instances of any size can be written by dotGenerator.\n", MAX_EDGE_BITS >> 20);
+    printf(" Compile without -fsanitize=address for meaningful numbers.\n");
+}
+
+/**
+ * @brief Returns the current time in seconds.
+ */
+double now()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Reads a file in a buffer followed by two null characters, as expected by parse_buffer.
+ *
+ * @param name The name of the file.
+ * @param size The address where the size of the file is stored.
+ * @return char* The buffer (to free), or NULL if the file could not be read.
+ */
+char *read_file(char *name, size_t *size)
+{
+    FILE *file = fopen(name, "rb");
+    if (file == NULL)
+        return NULL;
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    rewind(file);
+    char *buffer = (char *)calloc(*size + 2, 1);
+    if (fread(buffer, 1, *size, file) != *size)
+    {
+        free(buffer);
+        buffer = NULL;
+    }
+    fclose(file);
+    return buffer;
+}
+
+/**
+ * @brief Runs the flex scanner alone on a buffer, scanned in place.
+ *
+ * @param buffer The characters, followed by two null characters.
+ * @param size The number of characters.
+ * @return size_t The number of tokens read.
+ */
+size_t lex_buffer(char *buffer, size_t size)
+{
+    scannerState state;
+    yyscan_t scanner;
+    YYSTYPE value;
+    size_t num_tokens = 0;
+
+    state.tokens = NULL;
+    state.input = NULL;
+    if (yylex_init_extra(&state, &scanner))
+        return 0;
+    YY_BUFFER_STATE buffer_state = yy_scan_buffer(buffer, size + 2, scanner);
+    if (setjmp(state.on_error) == 0)
+        while (yylex(&value, scanner) != 0)
+            num_tokens++;
+    yy_delete_buffer(buffer_state, scanner);
+    yylex_destroy(scanner);
+    return num_tokens;
+}
+
+int main(int argc, char *argv[])
+{
+    int repetitions = 10;
+    int first = 1;
+    if (argc > 2 && strcmp(argv[1], "-n") == 0)
+    {
+        repetitions = atoi(argv[2]);
+        first = 3;
+    }
+    if (first >= argc || repetitions <= 0)
+    {
+        usage();
+        return 0;
+    }
+
+    for (int i = first; i < argc; i++)
+    {
+        size_t size;
+        char *source = read_file(argv[i], &size);
+        if (source == NULL)
+        {
+            printf("%s: cannot be read\n", argv[i]);
+            continue;
+        }
+        // The flex scanner writes in the buffer it scans: each scan gets a fresh copy.
+        char *buffer = (char *)malloc(size + 2);
+        double lex_time = 0, fast_time = 0, bison_time = 0, build_time = 0, network_time = 0;
+        bool fast_accepted = true;
+        bool built = false;
+        bool directed = false;
+        size_t num_tokens = 0;
+        int fast_nodes = 0, bison_nodes = 0;
+        size_t fast_edges = 0, bison_edges = 0;
+
+        for (int repetition = 0; repetition < repetitions; repetition++)
+        {
+            memcpy(buffer, source, size + 2);
+            double start = now();
+            num_tokens = lex_buffer(buffer, size);
+            lex_time += now() - start;
+
+            GraphBuilder fast_builder;
+            graph_builder_init(&fast_builder);
+            start = now();
+            fast_accepted = fast_parse(source, size, &fast_builder);
+            fast_time += now() - start;
+            fast_nodes = fast_builder.nodes.size;
+            fast_edges = fast_builder.edges.size;
+
+            GraphBuilder bison_builder;
+            memcpy(buffer, source, size + 2);
+            graph_builder_init(&bison_builder);
+            start = now();
+            parse_buffer(buffer, size, &bison_builder);
+            bison_time += now() - start;
+            bison_nodes = bison_builder.nodes.size;
+            bison_edges = bison_builder.edges.size;
+            directed = bison_builder.directed;
+
+            // The graph is built from the statements of the parser used by the program.
+            GraphBuilder *builder = fast_accepted ? &fast_builder : &bison_builder;
+            graph_builder_delete(fast_accepted ? &bison_builder : &fast_builder);
+            built = directed || (size_t)builder->nodes.size * builder->nodes.size / 8 <= MAX_EDGE_BITS;
+            if (!built)
+            {
+                graph_builder_delete(builder);
+                continue;
+            }
+            start = now();
+            Graph graph = graph_builder_finish(builder);
+            build_time += now() - start;
+
+            if (directed)
+            {
+                start = now();
+                TunnelNetwork network = tn_initialize(graph);
+                network_time += now() - start;
+                tn_delete(network);
+            }
+            graph_delete(graph);
+        }
+
+        double megabytes = (double)size * repetitions / 1e6;
+        double edges = (double)bison_edges * repetitions;
+        printf("%s: %zu bytes, %zu tokens, %d nodes, %zu edge statements\n", argv[i], size, num_tokens, bison_nodes, bison_edges);
+        printf("  lexing (flex):        %10.1f MB/s %14.0f tokens/s\n", megabytes / lex_time, (double)num_tokens * repetitions / lex_time);
+        if (fast_accepted)
+            printf("  parsing (fast):       %10.1f MB/s %14.0f edges/s%s\n", megabytes / fast_time, edges / fast_time, fast_nodes == bison_nodes && fast_edges == bison_edges ? "" : " (DIFFERENT RESULT)");
+        else
+            printf("  parsing (fast):       unsupported syntax, gave up after %.1f MB/s of scanning\n", megabytes / fast_time);
+        printf("  parsing (flex/bison): %10.1f MB/s %14.0f edges/s\n", megabytes / bison_time, edges / bison_time);
+        if (fast_accepted)
+            printf("  parser speedup:       %10.1fx\n", bison_time / fast_time);
+        if (!built)
+            printf("  graph not built: its bit-packed adjacency would take %zu MB\n", (size_t)bison_nodes * bison_nodes / 8 >> 20);
+        else
+        {
+            printf("  building the graph:   %10.3f ms %14.0f edges/s\n", build_time * 1e3 / repetitions, edges / build_time);
+            if (directed)
+                printf("  tn_initialize:        %10.3f ms %14.0f nodes/s\n", network_time * 1e3 / repetitions, (double)bison_nodes * repetitions / network_time);
+        }
+        free(buffer);
+        free(source);
+    }
+    return 0;
+}
@@ -52,6 +52,14 @@ void cg_print_colors(ColouredGraph graph);
  */
 void cg_delete(ColouredGraph graph);
 
+/**
+ * @brief Returns the number of bytes allocated for @p graph (the structure, the colours of the nodes and the nodes of each colour), not counting the Graph inside.
+ *
+ * @param graph A ColouredGraph.
+ * @return size_t The number of bytes.
+ */
+size_t cg_memory_usage(ColouredGraph graph);
+
 /**
  * @brief Returns the number of nodes of @p graph.
  *
@@ -79,6 +87,16 @@ int cg_get_num_edges(ColouredGraph graph);
  */
 bool cg_is_edge(ColouredGraph graph, int source, int target);
 
+/**
+ * @brief Gets the neighbours of @p node in @p graph, in increasing order, without scanning the other nodes.
+ *
+ * @param graph A ColouredGraph.
+ * @param node A node.
+ * @param neighbours Will point to the (read-only) array of neighbours of @p node.
+ * @return size_t The number of neighbours of @p node.
+ */
+size_t cg_get_neighbours(ColouredGraph graph, int node, const int **neighbours);
+
 /**
  * @brief Gets the name of @p node in @p graph. The name is what appears in the .dot file, while its number is local to this program.
  *
@@ -106,6 +124,25 @@ int cg_get_node_colour(ColouredGraph graph, int node);
  */
 void cg_set_node_colour(ColouredGraph graph, int node, int colour);
 
+/**
+ * @brief Tells if a neighbour of @p node has colour @p colour in @p graph. Tests 64 nodes per operation when the graph has a bit-packed adjacency (see graph_build_edge_bits).
+ *
+ * @param graph A ColouredGraph.
+ * @param node A node.
+ * @param colour A colour.
+ * @return true if a neighbour of @p node (possibly @p node itself, if it has a self-loop) has colour @p colour.
+ * @return false otherwise.
+ */
+bool cg_neighbour_has_colour(ColouredGraph graph, int node, int colour);
+
+/**
+ * @brief Returns the size of a clique of @p graph found greedily: at least that many colours are needed to colour it.
+ *
+ * @param graph A ColouredGraph.
+ * @return int The size of the clique (0 if the graph has no bit-packed adjacency).
+ */
+int cg_clique_lower_bound(ColouredGraph graph);
+
 /**
  * @brief Writes a dot file named <@p name>.dot representing @p graph with partition information.
  *
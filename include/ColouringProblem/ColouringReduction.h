@@ -15,41 +15,65 @@
 
 #include "Graph.h"
 #include "ColouredGraph.h"
+#include "Z3Tools.h"
 #include <z3.h>
 
+/**
+ * @brief Creates the table of the variables of the reduction of @p graph, with which its formula is built and its models decoded. Must be freed with variable_table_delete, before @p ctx is deleted.
+ *
+ * @param ctx The solver context.
+ * @param graph A ColouredGraph.
+ * @return VariableTable The table of the variables.
+ */
+VariableTable colouring_variable_table_create(Z3_context ctx, const ColouredGraph graph);
+
 /**
  * @brief Generates a propositional formula satisfiable if and only if there is a partition which satisfies every player and all components are connected.
  *
  * @param ctx The solver context.
+ * @param variables The table of the variables of the reduction of @p graph (see colouring_variable_table_create).
  * @param graph A ColouredGraph.
  * @param num_colours The number of colours available for colouring the graph.
  * @return Z3_ast The formula.
  * @pre @p graph must be initialized.
  */
-Z3_ast colouring_reduction(Z3_context ctx, const ColouredGraph graph, int num_colours);
+Z3_ast colouring_reduction(Z3_context ctx, VariableTable variables, const ColouredGraph graph, int num_colours);
+
+/**
+ * @brief Renames the variables of a formula obtained with colouring_reduction after what they represent ("node 2, color 1"...), to print it.
+ *        The variables of the reduction are numbered rather than named, so that building the formula does not format names.
+ *
+ * @param ctx The solver context.
+ * @param variables The table the formula was built with.
+ * @param formula The formula.
+ * @return Z3_ast The formula with named variables.
+ */
+Z3_ast colouring_readable_formula(Z3_context ctx, VariableTable variables, Z3_ast formula);
 
 /**
  * @brief Colours @p graph according to @p model.
  *
  * @param ctx The solver context.
+ * @param variables The table the formula of @p model was built with.
  * @param model A variable assignment.
  * @param graph A ColouredGraph.
  * @param num_colours The number of expected colours.
  * @pre @p model must be a valid model which has a truth value for each variable representing a pair colour, node.
  * @pre @p graph must be the ColouredGraph used to obtain @p model.
  */
-void colour_graph_from_model(Z3_context ctx, Z3_model model, ColouredGraph graph, int num_colours);
+void colour_graph_from_model(Z3_context ctx, VariableTable variables, Z3_model model, ColouredGraph graph, int num_colours);
 
 /**
  * @brief Prints the values of the variables in @p model. @p graph and @p num_colours are used to determine which values to print. @p model should have been obtained through the satisfaction of a formula obtained with colouring_reduction.
  *
  * @param ctx The solver context.
+ * @param variables The table the formula of @p model was built with.
  * @param model A model.
  * @param graph A ColouredGraph.
  * @param num_colours The number of expected colours.
  * @pre @p model must be a valid model which has a truth value for each variable representing a pair colour, node.
  * @pre @p graph must be the ColouredGraph used to obtain @p model
  */
-void colouring_print_model(Z3_context ctx, Z3_model model, ColouredGraph graph, int num_colours);
+void colouring_print_model(Z3_context ctx, VariableTable variables, Z3_model model, ColouredGraph graph, int num_colours);
 
 #endif
\ No newline at end of file
@@ -56,7 +56,8 @@ typedef struct tn_step
 } tn_step;
 
 /**
- * @brief Initializes a Tunnel Network from a Graph for use in the project. Parses node parameters to determine which are initial, final, and their actions.
+ * @brief Initializes a Tunnel Network from a Graph for use in the project. Parses node parameters to determine which are initial, final, and their actions,
+ * unless they are already stored in the graph (see tn_store_node_actions).
  * The graph is NOT copied (it is not supposed to be modified).
  * TODO: format of parsed parameters
  *
@@ -65,6 +66,22 @@ typedef struct tn_step
  */
 TunnelNetwork tn_initialize(Graph graph);
 
+/**
+ * @brief Stores the actions of the nodes of @p network, and its initial and final nodes, in @p graph (see graph_set_node_actions), so that they are saved with it in a snapshot.
+ *
+ * @param network A TunnelNetwork.
+ * @param graph The graph @p network was initialized from.
+ */
+void tn_store_node_actions(TunnelNetwork network, Graph *graph);
+
+/**
+ * @brief Returns the number of bytes allocated by tn_initialize for @p network (the structure and the actions of the nodes), not counting its graph.
+ *
+ * @param network A TunnelNetwork.
+ * @return size_t The number of bytes.
+ */
+size_t tn_memory_usage(TunnelNetwork network);
+
 /**
  * @brief Deallocates memory used by @p network. Does NOT deallocates the graph.
  *
@@ -114,6 +131,67 @@ int tn_get_num_edges(TunnelNetwork network);
  */
 bool tn_is_edge(TunnelNetwork network, int source, int target);
 
+/**
+ * @brief Gets the successors of @p node in @p network, in increasing order, without scanning the other nodes.
+ *
+ * @pre @p node must be between 0 and tn_get_num_nodes(@p network)-1.
+ * @param network
+ * @param node
+ * @param neighbours Will point to the (read-only) array of successors of @p node.
+ * @return size_t The number of successors of @p node.
+ */
+size_t tn_out_neighbours(TunnelNetwork network, int node, const int **neighbours);
+
+/**
+ * @brief Gets the predecessors of @p node in @p network, in increasing order, without scanning the other nodes.
+ *
+ * @pre @p node must be between 0 and tn_get_num_nodes(@p network)-1.
+ * @param network
+ * @param node
+ * @param neighbours Will point to the (read-only) array of predecessors of @p node.
+ * @return size_t The number of predecessors of @p node.
+ */
+size_t tn_in_neighbours(TunnelNetwork network, int node, const int **neighbours);
+
+/**
+ * @brief Returns the number of successors of @p node in @p network, in constant time.
+ *
+ * @pre @p node must be between 0 and tn_get_num_nodes(@p network)-1.
+ * @param network
+ * @param node
+ * @return size_t The out-degree of @p node.
+ */
+size_t tn_out_degree(TunnelNetwork network, int node);
+
+/**
+ * @brief Returns the number of predecessors of @p node in @p network, in constant time.
+ *
+ * @pre @p node must be between 0 and tn_get_num_nodes(@p network)-1.
+ * @param network
+ * @param node
+ * @return size_t The in-degree of @p node.
+ */
+size_t tn_in_degree(TunnelNetwork network, int node);
+
+/**
+ * @brief Computes the nodes of @p network reachable from its initial node, following edges regardless of actions. Linear in the size of @p network.
+ *
+ * @param network
+ * @param reached An array of tn_get_num_nodes(@p network) booleans, set to true exactly for the nodes reachable from the initial node.
+ * @return int The number of such nodes.
+ */
+int tn_reachable_from_initial(TunnelNetwork network, bool *reached);
+
+/**
+ * @brief Computes the nodes of @p network from which its final node is reachable, following edges regardless of actions (backward search over predecessors). Linear in the size of @p network.
+ * A node outside of this set cannot be on a path to the final node.
+ *
+ * @param network
+ * @param reached An array of tn_get_num_nodes(@p network) booleans, set to true exactly for the nodes from which the final node is reachable.
+ * @return int The number of such nodes.
+ */
+int tn_coreachable_to_final(TunnelNetwork network, bool *reached);
+
 /**
  * @brief Returns the name of @p node in @p network.
  *
@@ -14,39 +14,64 @@
 #define TUNNEL_RED_H
 
 #include "TunnelNetwork.h"
+#include "Z3Tools.h"
 #include <z3.h>
 
+/**
+ * @brief Creates the table of the variables of the reductions of @p network. The formulae of all the sizes are built with the same table, so that they share their variables,
+ *        and their models are decoded with it. Must be freed with variable_table_delete, before @p ctx is deleted.
+ *
+ * @param ctx The solver context.
+ * @param network A Tunnel Network.
+ * @return VariableTable The table of the variables.
+ */
+VariableTable tn_variable_table_create(Z3_context ctx, const TunnelNetwork network);
+
 /**
  * @brief Generates a propositional formula satisfiable if and only if there is a well-formed simple path of size @p bound from the initial node of @p network to its final node.
  *
  * @param ctx The solver context.
+ * @param variables The table of the variables of the reductions of @p network (see tn_variable_table_create).
  * @param network A Tunnel Network.
  * @param length The size of the target path.
  * @return Z3_ast The formula
  * @pre @p network must be initialized.
  */
-Z3_ast tn_reduction(Z3_context ctx, const TunnelNetwork network, int length);
+Z3_ast tn_reduction(Z3_context ctx, VariableTable variables, const TunnelNetwork network, int length);
+
+/**
+ * @brief Renames the variables of a formula obtained with tn_reduction after what they represent ("node 2,pos 1, height 0"...), to print it.
+ *        The variables of the reduction are numbered rather than named, so that building the formula does not format names.
+ *
+ * @param ctx The solver context.
+ * @param variables The table the formula was built with.
+ * @param formula The formula.
+ * @return Z3_ast The formula with named variables.
+ */
+Z3_ast tn_readable_formula(Z3_context ctx, VariableTable variables, Z3_ast formula);
 
 /**
  * @brief Gets the well-formed path from the model @p model.
  *
  * @param ctx The solver context.
+ * @param variables The table the formula of @p model was built with.
  * @param model A variable assignment.
  * @param network A Tunnel Network.
  * @param bound The size of the path.
  * @param path The path
  * @pre @p path must be an array of size @p bound+1.
  */
-void tn_get_path_from_model(Z3_context ctx, Z3_model model, TunnelNetwork network, int bound, tn_step *path);
+void tn_get_path_from_model(Z3_context ctx, VariableTable variables, Z3_model model, TunnelNetwork network, int bound, tn_step *path);
 
 /**
  * @brief Prints (in pretty format) which variables used by the tunnel reduction are true in @p model.
  *
  * @param ctx The solver context.
+ * @param variables The table the formula of @p model was built with.
  * @param model A variable assignment.
  * @param network A tunnel network.
  * @param bound The size of the path.
  */
-void tn_print_model(Z3_context ctx, Z3_model model, TunnelNetwork network, int bound);
+void tn_print_model(Z3_context ctx, VariableTable variables, Z3_model model, TunnelNetwork network, int bound);
 
 #endif
\ No newline at end of file
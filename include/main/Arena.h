@@ -0,0 +1,100 @@
+/**
+ * @file Arena.h
+ * @brief Region (bump) allocator. Memory is taken by moving a pointer inside large blocks, and is only given back all at once, when the last reference to the arena is released.
+ *        Graphs keep all their storage in arenas, so that deleting one does not walk its nodes, edges and parameters.
+ * @version 1
+ * @date 2026-10-15
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#ifndef COCA_ARENA_H_
+#define COCA_ARENA_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief A reference-counted region of memory.
+ *
+ */
+typedef struct arena_s *Arena;
+
+/**
+ * @brief Creates an empty arena, with one reference.
+ *
+ * @return Arena The arena.
+ */
+Arena arena_create(void);
+
+/**
+ * @brief Adds a reference to @p arena.
+ *
+ * @param arena An arena.
+ * @return Arena @p arena.
+ */
+Arena arena_retain(Arena arena);
+
+/**
+ * @brief Removes a reference to @p arena. When there is none left, frees all memory allocated in it (in one step per block: blocks grow geometrically up to a bound, and large allocations have their own).
+ *
+ * @param arena An arena.
+ */
+void arena_release(Arena arena);
+
+/**
+ * @brief Registers a function called on @p data when @p arena is freed, to release resources the memory of the arena refers to (such as a mapped file). Functions are called in reverse order of registration.
+ *
+ * @param arena An arena.
+ * @param cleanup The function.
+ * @param data Its argument.
+ */
+void arena_add_cleanup(Arena arena, void (*cleanup)(void *), void *data);
+
+/**
+ * @brief Tells if @p arena has more than one reference.
+ *
+ * @param arena An arena.
+ * @return true If it has several references.
+ * @return false Otherwise.
+ */
+bool arena_is_shared(Arena arena);
+
+/**
+ * @brief Allocates @p size bytes in @p arena, aligned for any type. The memory is not initialised, and lives as long as @p arena.
+ *
+ * @param arena An arena.
+ * @param size A number of bytes.
+ * @return void* The allocated memory.
+ */
+void *arena_alloc(Arena arena, size_t size);
+
+/**
+ * @brief Copies @p string in @p arena.
+ *
+ * @param arena An arena.
+ * @param string A string.
+ * @return char* The copy.
+ */
+char *arena_strdup(Arena arena, const char *string);
+
+/**
+ * @brief Copies the @p length first characters of @p string (which need not be null-terminated) in @p arena, followed by a null character.
+ *
+ * @param arena An arena.
+ * @param string A sequence of characters.
+ * @param length Its length.
+ * @return char* The null-terminated copy.
+ */
+char *arena_strndup(Arena arena, const char *string, size_t length);
+
+/**
+ * @brief Returns the number of bytes allocated in @p arena (including alignment padding).
+ *
+ * @param arena An arena.
+ * @return size_t The number of bytes.
+ */
+size_t arena_used(Arena arena);
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * @file Atoms.h
+ * @brief Global table of interned strings. Each distinct string is stored once and identified by an integer (an atom), so that parameter names and values can be compared
+ *        and looked up as integers instead of with strcmp. The table can be used by several threads: reading a string and looking up a string already interned
+ *        take no lock, only adding a new string does.
+ * @version 1
+ * @date 2026-10-15
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#ifndef COCA_ATOMS_H_
+#define COCA_ATOMS_H_
+
+#include <stddef.h>
+
+/**
+ * @brief Identifier of an interned string. Two equal strings always have the same atom.
+ *
+ */
+typedef int atom;
+
+/**
+ * @brief Atom value meaning "no string".
+ *
+ */
+#define NO_ATOM (-1)
+
+/**
+ * @brief Interns @p string: returns its atom, adding a copy of it to the table if it was not already present.
+ *
+ * @param string A string.
+ * @return atom The atom of @p string.
+ */
+atom atom_intern(const char *string);
+
+/**
+ * @brief Interns the @p length first characters of @p string (which need not be null-terminated).
+ *
+ * @param string A sequence of characters.
+ * @param length Its length.
+ * @return atom The atom of the sequence.
+ */
+atom atom_intern_length(const char *string, int length);
+
+/**
+ * @brief Returns the atom of @p string if it has been interned, NO_ATOM otherwise. Does not modify the table.
+ *
+ * @param string A string.
+ * @return atom The atom of @p string, or NO_ATOM.
+ */
+atom atom_lookup(const char *string);
+
+/**
+ * @brief Returns the interned string of @p id. The string is owned by the table and lives until the end of the program: it must not be modified nor freed.
+ *
+ * @param id An atom.
+ * @return char* Its string.
+ * @pre @p id must have been returned by atom_intern.
+ */
+char *atom_string(atom id);
+
+/**
+ * @brief Returns the number of atoms interned so far. Atoms are the integers from 0 to this number minus one.
+ *
+ * @return int The number of atoms.
+ */
+int atom_count(void);
+
+/**
+ * @brief Returns the number of bytes used by the table of interned strings (index and characters).
+ *
+ * @return size_t The number of bytes.
+ */
+size_t atom_memory_usage(void);
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * @file Bitset.h
+ * @brief Arrays of bits packed in 64-bit words, with word-parallel operations (intersection, population count). Uses AVX2 when the compiler targets it.
+ * @version 1
+ * @date 2026-10-15
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#ifndef COCA_BITSET_H_
+#define COCA_BITSET_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Number of bits in a word of a bitset.
+ *
+ */
+#define BITSET_WORD_BITS 64
+
+/**
+ * @brief Returns the number of words needed to store @p num_bits bits.
+ *
+ * @param num_bits A number of bits.
+ * @return size_t The number of words.
+ */
+size_t bitset_num_words(size_t num_bits);
+
+/**
+ * @brief Allocates a bitset of @p num_bits bits, all unset. Must be freed with free.
+ *
+ * @param num_bits The number of bits.
+ * @return uint64_t* The bitset.
+ */
+uint64_t *bitset_create(size_t num_bits);
+
+/**
+ * @brief Sets the bit @p index of @p bits.
+ *
+ * @param bits A bitset.
+ * @param index A bit.
+ */
+void bitset_set(uint64_t *bits, size_t index);
+
+/**
+ * @brief Unsets the bit @p index of @p bits.
+ *
+ * @param bits A bitset.
+ * @param index A bit.
+ */
+void bitset_clear(uint64_t *bits, size_t index);
+
+/**
+ * @brief Tells if the bit @p index of @p bits is set.
+ *
+ * @param bits A bitset.
+ * @param index A bit.
+ * @return true if the bit is set.
+ * @return false otherwise.
+ */
+bool bitset_test(const uint64_t *bits, size_t index);
+
+/**
+ * @brief Counts the bits set in the @p num_words first words of @p bits.
+ *
+ * @param bits A bitset.
+ * @param num_words Its number of words.
+ * @return size_t The number of bits set.
+ */
+size_t bitset_popcount(const uint64_t *bits, size_t num_words);
+
+/**
+ * @brief Tells if @p first and @p second have a common bit set. Stops at the first common word.
+ *
+ * @param first A bitset.
+ * @param second A bitset.
+ * @param num_words Their number of words.
+ * @return true if a bit is set in both.
+ * @return false otherwise.
+ */
+bool bitset_intersects(const uint64_t *first, const uint64_t *second, size_t num_words);
+
+/**
+ * @brief Stores the intersection of @p first and @p second in @p result (which may be one of them), and counts its bits.
+ *
+ * @param result The bitset receiving the intersection.
+ * @param first A bitset.
+ * @param second A bitset.
+ * @param num_words Their number of words.
+ * @return size_t The number of bits set in the intersection.
+ */
+size_t bitset_and(uint64_t *result, const uint64_t *first, const uint64_t *second, size_t num_words);
+
+/**
+ * @brief Returns the index of the first bit set in @p bits, or -1 if there is none.
+ *
+ * @param bits A bitset.
+ * @param num_words Its number of words.
+ * @return long The first bit set, or -1.
+ */
+long bitset_first(const uint64_t *bits, size_t num_words);
+
+#endif
@@ -14,24 +14,70 @@
 #define COCA_GRAPH_H_
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
+#include "Arena.h"
+#include "Atoms.h"
+#include "Bitset.h"
 
 /**
- * @brief List of arbitrary parameters
+ * @brief List of arbitrary parameters. Cells are allocated in an arena, and names and values are interned (see Atoms.h): a list is never freed by itself.
+ *        A value may also be kept as a span of the source of the graph, and only interned the first time it is read (see parameter_list_add_span).
  *
  */
 typedef struct tag_paramList
 {
 	char *name;					///< The name (key) of the parameter.
-	char *value;				///< The value of the parameter.
+	char *value;				///< The value of the parameter (NULL while it is not decoded).
+	atom name_atom;				///< The atom of the name.
+	atom value_atom;			///< The atom of the value (NO_ATOM while it is not decoded).
+	const char *span;			///< The characters of the value in the source, while it is not decoded (NULL otherwise).
+	int span_length;			///< The number of characters of span.
 	struct tag_paramList *next; ///< Pointer to the next parameter (NULL if last).
 } parameterList;
 
 /**
- * @brief Adds a parameter if not already present
+ * @brief Adds a parameter at the end of @p list if not already present. @p name and @p value are interned, not kept.
  *
+ * @param arena The arena in which the new cell is allocated.
+ * @param list A parameter list (may be NULL).
+ * @param name The name of the parameter.
+ * @param value Its value.
+ * @return parameterList* The list with the parameter.
  */
-parameterList *parameter_list_add_parameter(parameterList *list, char *name, char *value);
+parameterList *parameter_list_add_parameter(Arena arena, parameterList *list, char *name, char *value);
+
+/**
+ * @brief Adds a parameter, given by the atoms of its name and value, at the end of @p list if not already present.
+ *
+ * @param arena The arena in which the new cell is allocated.
+ * @param list A parameter list (may be NULL).
+ * @param name_atom The atom of the name of the parameter.
+ * @param value_atom The atom of its value.
+ * @return parameterList* The list with the parameter.
+ */
+parameterList *parameter_list_add_atoms(Arena arena, parameterList *list, atom name_atom, atom value_atom);
+
+/**
+ * @brief Adds a parameter whose value is kept as a span of the source, at the end of @p list if not already present. The value is interned the first time it is read
+ *        (by parameter_list_get_atom, parameter_list_decode, or the functions of the graph giving parameters), so that values which are never read cost no string.
+ *
+ * @param arena The arena in which the new cell is allocated.
+ * @param list A parameter list (may be NULL).
+ * @param name_atom The atom of the name of the parameter.
+ * @param value The characters of the value, which must live as long as the list (see the source_arena field of Graph).
+ * @param length Their number.
+ * @return parameterList* The list with the parameter.
+ */
+parameterList *parameter_list_add_span(Arena arena, parameterList *list, atom name_atom, const char *value, int length);
+
+/**
+ * @brief Decodes the values of @p list still kept as spans of the source.
+ *
+ * @param list A parameter list (may be NULL).
+ * @return parameterList* @p list, whose values are all interned.
+ */
+parameterList *parameter_list_decode(parameterList *list);
 
 /**
  * @brief Appends tail to head and returns a pointer to the result.
@@ -42,12 +88,13 @@ parameterList *parameter_list_add_parameter(parameterList *list, char *name, cha
 parameterList *parameter_lists_merge(parameterList *head, parameterList *tail);
 
 /**
- * @brief Copies a parameter list. Every inner field is copied.
+ * @brief Copies a parameter list in @p arena. The cells are copied, the interned strings (and the spans of values not yet decoded) are shared.
  *
+ * @param arena The arena in which the copy is allocated.
  * @param source the list to copy.
  * @return parameterList* A copy of source.
  */
-parameterList *parameter_list_copy(parameterList *source);
+parameterList *parameter_list_copy(Arena arena, parameterList *source);
 
 /**
  * @brief Get the value associated with name within a list of parameters. Exits the program if not present.
@@ -59,26 +106,127 @@ parameterList *parameter_list_copy(parameterList *source);
 char *parameter_list_get_value(parameterList *list, char *name);
 
 /**
- * @brief Frees a list of parameters
+ * @brief Get the atom of the value associated with the atom @p name within a list of parameters. Only compares integers. The value is decoded if it was kept as a span.
+ *
+ * @param list A list of parameters.
+ * @param name The atom of the name of the field to search.
+ * @return atom The atom of the value associated with @p name in @p list, or NO_ATOM if not present.
+ */
+atom parameter_list_get_atom(parameterList *list, atom name);
+
+/**
+ * @brief A slot of the table of edge parameters.
+ *
+ */
+typedef struct
+{
+	int source;				   ///< The source of the edge (-1 if the slot is free).
+	int target;				   ///< The target of the edge.
+	parameterList *parameters; ///< The parameters of the edge.
+} edgeParameterSlot;
+
+/**
+ * @brief Open-addressed hash table (linear probing) associating parameters to edges. Only edges having parameters are stored, so its size is proportional to them and not to the square of the number of nodes.
  *
  */
-void parameter_list_delete(parameterList *list);
+typedef struct
+{
+	size_t capacity;		 ///< The number of slots (0 or a power of 2).
+	size_t size;			 ///< The number of occupied slots.
+	edgeParameterSlot *slots; ///< The slots (NULL if capacity is 0).
+	Arena arena;			 ///< The arena holding the slots and their parameter lists.
+} edgeParameterTable;
 
-/** @brief: the graph type. The first four fields are needed to represent a directed graph. The rest depends on needs. Here, the rest represents initial and final states of an automaton.*/
+/** @brief: the graph type. The first four fields are needed to represent a directed graph. The rest depends on needs. Here, the rest represents initial and final states of an automaton.
+ * All the storage of a graph lives in arenas, in three parts: the structure (name, nodes, edges and adjacency), the parameters of the nodes and the parameters of the edges. Copies made by graph_copy share the arenas of these parts, and a part is copied (in a new arena) only when a copy modifies it.*/
 typedef struct
 {
 	char *name;	  ///< The name of the graph/automaton
 	int numNodes; ///< The number of nodes of the graph.
 	int numEdges; ///< The number of edges of the graph.
 	char **nodes; ///< The names of nodes of the graph.
-	bool *edges;  ///< The edges of the graph.
+	bool *edges;  ///< The edges of the graph, as a matrix (NULL if not built, as for snapshots: graph_is_edge then reads edge_bits or the adjacency).
+
+	parameterList **parameters;		 ///< Parameters of the nodes (pointers into parameter_block, NULL if a node has none).
+	parameterList *parameter_block;	 ///< Storage of the parameters of all nodes: those of a node are consecutive.
+	edgeParameterTable edge_parameters; ///< Parameters of the edges, indexed by (source, target).
+
+	size_t *out_offsets; ///< Compressed sparse row index of successors: those of node n are out_targets[out_offsets[n]] to out_targets[out_offsets[n+1]-1].
+	int *out_targets;	 ///< Successors of every node, sorted by source then by target.
+	size_t *in_offsets;	 ///< Compressed sparse row index of predecessors: those of node n are in_sources[in_offsets[n]] to in_sources[in_offsets[n+1]-1].
+	int *in_sources;	 ///< Predecessors of every node, sorted by target then by source.
+
+	uint64_t *edge_bits;	 ///< Optional bit-packed adjacency (NULL if not built): the successors of node n are the bits set in the edge_bits_words words starting at edge_bits[n * edge_bits_words].
+	size_t edge_bits_words; ///< The number of words of a row of edge_bits.
+
+	int *name_slots;		   ///< Open-addressed hash index from node names to nodes (-1 for a free slot).
+	size_t name_slots_capacity; ///< The number of slots of name_slots (a power of 2).
 
-	parameterList **parameters;		 ///< Parameters of the nodes.
-	parameterList **edge_parameters; ///< Parameters of the edges
+	int *node_actions; ///< Precomputed masks of the actions of the nodes, when the graph is a tunnel network (NULL if not known).
+	int initial;	   ///< Precomputed initial node (-1 if not known).
+	int final;		   ///< Precomputed final node (-1 if not known).
+
+	Arena structure_arena;	///< The arena holding name, nodes, the name index, edges, the adjacency arrays, edge_bits and node_actions.
+	Arena parameters_arena; ///< The arena holding parameters and parameter_block.
+	Arena source_arena;		///< Keeps alive the source the values of parameters not yet decoded refer to (NULL if there are none).
 } Graph;
 
 /**
- * @brief Creates a copy of the graph passed in argument.
+ * @brief Memory used by the parts of a graph, in bytes.
+ *
+ */
+typedef struct
+{
+	size_t edge_matrix;		///< The matrix of edges.
+	size_t adjacency;		///< The compressed sparse row adjacency (successors and predecessors).
+	size_t edge_bits;		///< The bit-packed adjacency.
+	size_t names;			///< The names of the graph and of the nodes, with the name index.
+	size_t node_parameters; ///< The parameters of the nodes.
+	size_t edge_parameters; ///< The table of parameters of the edges, with their lists.
+	size_t node_actions;	///< The precomputed masks of actions of the nodes.
+	size_t arenas;			///< All the memory allocated in the arenas of the graph (including parts replaced since, and parts shared with copies).
+} graphMemory;
+
+/**
+ * @brief Returns the slot where the search for the name @p name starts in a name index of @p capacity slots (the index is probed linearly from there). Numeric names (such as "185") are hashed from their value, without hashing their characters. The parser builds its index with it, and hands that index over to the graph.
+ *
+ * @param name A name of node (need not be null-terminated).
+ * @param length Its length.
+ * @param capacity The number of slots of the index (a power of 2).
+ * @return size_t The first slot to probe.
+ */
+size_t graph_name_slot(const char *name, size_t length, size_t capacity);
+
+/**
+ * @brief Builds the compressed sparse row adjacency (successors and predecessors) of @p graph from a list of edges, in time linear in the number of nodes and edges.
+ * Neighbours of each node are sorted by increasing identifier, and repeated edges are kept once.
+ * The adjacency is allocated in the structure arena of @p graph. The other fields of the structure (edge_bits, node_actions, initial and final) are set as not known.
+ *
+ * @param graph A graph whose numNodes and structure_arena fields are set.
+ * @param sources The sources of the edges.
+ * @param targets The targets of the edges.
+ * @param num_pairs The number of edges in @p sources and @p targets (counting repetitions).
+ */
+void graph_build_adjacency(Graph *graph, const int *sources, const int *targets, size_t num_pairs);
+
+/**
+ * @brief Builds the bit-packed adjacency of @p graph (one bit per pair of nodes) from its compressed sparse row adjacency, allowing word-parallel operations on neighbourhoods. Does nothing if already built.
+ * If the structure of @p graph is shared with copies, it is copied first.
+ *
+ * @param graph A graph whose adjacency is built.
+ */
+void graph_build_edge_bits(Graph *graph);
+
+/**
+ * @brief Sets the parameters of the nodes of @p graph to copies of @p lists, stored in a single compact block (the parameters of each node are consecutive) of its parameters arena.
+ *
+ * @param graph A graph whose numNodes and parameters_arena fields are set.
+ * @param lists The parameter lists of each node (not modified).
+ */
+void graph_build_node_parameters(Graph *graph, parameterList **lists);
+
+/**
+ * @brief Creates a copy of the graph passed in argument. Runs in constant time: the copy shares the storage of @p graph until one of them is modified (by graph_set_edge_parameter, graph_build_edge_bits or graph_set_node_actions). Both must be deleted with graph_delete.
  *
  * @param graph A graph.
  * @return graph A copy of graph.
@@ -96,7 +244,7 @@ Graph graph_copy(Graph graph);
 void graph_print(Graph graph);
 
 /**
- * @brief Frees all memory occupied by a graph.
+ * @brief Frees all memory occupied by a graph, except the parts still shared with copies of it. Only releases its arenas: the time taken does not depend on the size of the graph.
  *
  * @param graph The graph to delete.
  *
@@ -133,7 +281,7 @@ int graph_num_nodes(Graph graph);
 int graph_num_edges(Graph graph);
 
 /**
- * @brief Tells if (@p source, @p target) is an edge in @p graph.
+ * @brief Tells if (@p source, @p target) is an edge in @p graph. Constant time with the matrix of edges or the bit-packed adjacency, logarithmic in the degree of @p source otherwise.
  *
  * @param graph A graph.
  * @param source The source of the edge.
@@ -147,7 +295,136 @@ int graph_num_edges(Graph graph);
 bool graph_is_edge(Graph graph, int source, int target);
 
 /**
- * @brief Returns the parameter list associated to edge (@p source, @p target). Returns NULL if no parameter exists (or the edge doesn't exist).
+ * @brief Gets the successors of @p node in @p graph, in increasing order. Runs in constant time.
+ *
+ * @param graph A graph.
+ * @param node A node.
+ * @param neighbours Will point to the (read-only) array of successors of @p node.
+ * @return size_t The number of successors of @p node.
+ * @pre @p graph must be a valid graph.
+ * @pre 0 <= @p node < @p graph.numNodes
+ */
+size_t graph_out_neighbours(Graph graph, int node, const int **neighbours);
+
+/**
+ * @brief Gets the predecessors of @p node in @p graph, in increasing order. Runs in constant time.
+ *
+ * @param graph A graph.
+ * @param node A node.
+ * @param neighbours Will point to the (read-only) array of predecessors of @p node.
+ * @return size_t The number of predecessors of @p node.
+ * @pre @p graph must be a valid graph.
+ * @pre 0 <= @p node < @p graph.numNodes
+ */
+size_t graph_in_neighbours(Graph graph, int node, const int **neighbours);
+
+/**
+ * @brief Returns the number of successors of @p node in @p graph. Runs in constant time.
+ *
+ * @param graph A graph.
+ * @param node A node.
+ * @return size_t The out-degree of @p node.
+ * @pre @p graph must be a valid graph.
+ * @pre 0 <= @p node < @p graph.numNodes
+ */
+size_t graph_out_degree(Graph graph, int node);
+
+/**
+ * @brief Returns the number of predecessors of @p node in @p graph. Runs in constant time.
+ *
+ * @param graph A graph.
+ * @param node A node.
+ * @return size_t The in-degree of @p node.
+ * @pre @p graph must be a valid graph.
+ * @pre 0 <= @p node < @p graph.numNodes
+ */
+size_t graph_in_degree(Graph graph, int node);
+
+/**
+ * @brief Computes the nodes reachable from @p source in @p graph (including @p source) by a breadth-first search over successors. Runs in time linear in the number of nodes and edges.
+ *
+ * @param graph A graph.
+ * @param source A node.
+ * @param reached An array of graph_num_nodes(@p graph) booleans, set to true exactly for the nodes reachable from @p source.
+ * @return int The number of nodes reachable from @p source.
+ * @pre @p graph must be a valid graph.
+ * @pre 0 <= @p source < @p graph.numNodes
+ */
+int graph_reachable(Graph graph, int source, bool *reached);
+
+/**
+ * @brief Computes the nodes from which @p target is reachable in @p graph (including @p target) by a breadth-first search over predecessors. Runs in time linear in the number of nodes and edges.
+ *
+ * @param graph A graph.
+ * @param target A node.
+ * @param reached An array of graph_num_nodes(@p graph) booleans, set to true exactly for the nodes from which @p target is reachable.
+ * @return int The number of nodes from which @p target is reachable.
+ * @pre @p graph must be a valid graph.
+ * @pre 0 <= @p target < @p graph.numNodes
+ */
+int graph_coreachable(Graph graph, int target, bool *reached);
+
+/**
+ * @brief Tells if the bit-packed adjacency of @p graph is built (see graph_build_edge_bits).
+ *
+ * @param graph A graph.
+ * @return true If it is built.
+ * @return false Otherwise.
+ */
+bool graph_has_edge_bits(Graph graph);
+
+/**
+ * @brief Returns the number of words of a row of the bit-packed adjacency of @p graph.
+ *
+ * @param graph A graph.
+ * @return size_t The number of words of a row.
+ */
+size_t graph_edge_bits_words(Graph graph);
+
+/**
+ * @brief Gets the successors of @p node in @p graph as a bitset of graph_edge_bits_words(@p graph) words.
+ *
+ * @param graph A graph.
+ * @param node A node.
+ * @return const uint64_t* The (read-only) row of @p node.
+ * @pre The bit-packed adjacency of @p graph must be built.
+ * @pre 0 <= @p node < @p graph.numNodes
+ */
+const uint64_t *graph_edge_bits_row(Graph graph, int node);
+
+/**
+ * @brief Counts the successors of @p node in @p graph by population count of its row.
+ *
+ * @param graph A graph.
+ * @param node A node.
+ * @return size_t The number of successors of @p node.
+ * @pre The bit-packed adjacency of @p graph must be built.
+ * @pre 0 <= @p node < @p graph.numNodes
+ */
+size_t graph_bits_degree(Graph graph, int node);
+
+/**
+ * @brief Computes the common successors of @p first and @p second, 64 nodes per operation.
+ *
+ * @param graph A graph.
+ * @param first A node.
+ * @param second A node.
+ * @param result A bitset of graph_edge_bits_words(@p graph) words, receiving the common successors.
+ * @return size_t The number of common successors.
+ * @pre The bit-packed adjacency of @p graph must be built.
+ */
+size_t graph_common_neighbours(Graph graph, int first, int second, uint64_t *result);
+
+/**
+ * @brief Computes greedily a clique of the (undirected) graph @p graph and returns its size, which is a lower bound of its chromatic number. Self-loops are ignored.
+ *
+ * @param graph A graph.
+ * @return int The size of the clique found (0 if the bit-packed adjacency is not built or the graph is empty).
+ */
+int graph_greedy_clique_size(Graph graph);
+
+/**
+ * @brief Returns the parameter list associated to edge (@p source, @p target), with all its values decoded. Returns NULL if no parameter exists (or the edge doesn't exist).
  *
  * @param graph A graph.
  * @param source The source of the edge.
@@ -159,7 +436,21 @@ bool graph_is_edge(Graph graph, int source, int target);
 parameterList *graph_get_edge_parameter(Graph graph, int source, int target);
 
 /**
- * @brief Return the parameter list associated to node @p node. Returns NULL if no parameter exists.
+ * @brief Associates a copy of the parameter list @p parameters to edge (@p source, @p target), replacing the previous one. The copy is allocated in the arena of the edge parameters of @p graph.
+ * If the parameters of the edges of @p graph are shared with copies, they are copied first.
+ *
+ * @param graph A graph.
+ * @param source The source of the edge.
+ * @param target The target of the edge.
+ * @param parameters A parameter list (may be NULL). It is not modified.
+ * @pre @p graph must be a valid graph.
+ * @pre 0 <= @p source < @p graph.numNodes
+ * @pre 0 <= @p target < @p graph.numNodes
+ */
+void graph_set_edge_parameter(Graph *graph, int source, int target, parameterList *parameters);
+
+/**
+ * @brief Return the parameter list associated to node @p node, with all its values decoded. Returns NULL if no parameter exists.
  *
  * @param graph A graph.
  * @param node Its node.
@@ -169,6 +460,18 @@ parameterList *graph_get_edge_parameter(Graph graph, int source, int target);
  */
 parameterList *graph_get_node_parameter(Graph graph, int node);
 
+/**
+ * @brief Returns the value of parameter @p name of node @p node, as an atom. Compares integers only.
+ *
+ * @param graph A graph.
+ * @param node Its node.
+ * @param name The atom of the name of the parameter.
+ * @return atom The atom of the value, or NO_ATOM if @p node has no such parameter.
+ * @pre @p graph must be a valid graph.
+ * @pre 0 <= @p node < @p graph.numNodes.
+ */
+atom graph_get_node_attribute(Graph graph, int node, atom name);
+
 /**
  * @brief Returns the name of a node given its identifier.
  *
@@ -180,6 +483,68 @@ parameterList *graph_get_node_parameter(Graph graph, int node);
  */
 char *graph_get_node_name(Graph graph, int node);
 
+/**
+ * @brief Stores in @p graph precomputed information about the automaton (or tunnel network) it represents: a mask of actions for each node, and its initial and final nodes.
+ * If the structure of @p graph is shared with copies, it is copied first.
+ *
+ * @param graph A graph.
+ * @param node_actions The masks of actions of the nodes (copied).
+ * @param initial The initial node.
+ * @param final The final node.
+ */
+void graph_set_node_actions(Graph *graph, const int *node_actions, int initial, int final);
+
+/**
+ * @brief Returns the precomputed masks of actions of the nodes of @p graph (see graph_set_node_actions), or NULL if there are none.
+ *
+ * @param graph A graph.
+ * @return const int* The masks of actions of the nodes, or NULL.
+ */
+const int *graph_get_node_actions(Graph graph);
+
+/**
+ * @brief Returns the precomputed initial node of @p graph (see graph_set_node_actions).
+ *
+ * @param graph A graph.
+ * @return int The initial node, or -1 if not known.
+ */
+int graph_get_initial(Graph graph);
+
+/**
+ * @brief Returns the precomputed final node of @p graph (see graph_set_node_actions).
+ *
+ * @param graph A graph.
+ * @return int The final node, or -1 if not known.
+ */
+int graph_get_final(Graph graph);
+
+/**
+ * @brief Returns the identifier of the node named @p name in @p graph. Runs in expected constant time.
+ *
+ * @param graph A graph.
+ * @param name A name of node.
+ * @return int The identifier of the node named @p name, or -1 if there is none.
+ * @pre @p graph must be a valid graph.
+ */
+int graph_find_node(Graph graph, const char *name);
+
+/**
+ * @brief Measures the memory used by each part of @p graph. Parts shared with copies are counted in each of them.
+ *
+ * @param graph A graph.
+ * @return graphMemory The number of bytes of each part.
+ * @pre @p graph must be a valid graph.
+ */
+graphMemory graph_memory_usage(Graph graph);
+
+/**
+ * @brief Displays the memory used by each part of @p graph (see graph_memory_usage).
+ *
+ * @param graph A graph.
+ * @pre @p graph must be a valid graph.
+ */
+void graph_print_memory_usage(Graph graph);
+
 /**
  * @brief Writes in @p file the content of @p graph (with parameters) in dot format. For undirected graphs only.
  *
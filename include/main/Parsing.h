@@ -1,7 +1,7 @@
 /**
  * @file Parsing.h
  * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
- * @brief Contains function to convert graphviz files to the GraphList structure. Needs first to compile Lexer.l and Parser.y with bison.
+ * @brief Contains function to convert graphviz files to the Graph structure. Needs first to compile Lexer.l and Parser.y with bison.
  * @version 1
  * @date 2019-07-31
  * 
@@ -12,16 +12,91 @@
 #ifndef COCA_PARSING_H_
 #define COCA_PARSING_H_
 
-#include "GraphList.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
 #include "Graph.h"
+#include "GraphBuilder.h"
 
 /**
  * @brief Parses a file and return the Graph described by it. If the file with the name given in argument does not exists, it displays an error message and exits the program.
  * 
  * @param toRead the name of a file in graphviz format.
- * @return GraphList The parsed GraphList.
+ * @return Graph The parsed Graph.
  * @pre @p toRead must be an existing file in graphviz format.
  */
 Graph get_graph_from_file(char *toRead);
 
+/**
+ * @brief Parses a file and stores the Graph described by it, without exiting on errors. Can be called from several threads at the same time.
+ *        Syntax errors are reported, and the graph then contains what was parsed before the error.
+ *        Files compressed with gzip (or zstd, when compiled with HAVE_ZSTD) are recognized by their first bytes, and decompressed while they are scanned.
+ * 
+ * @param toRead the name of a file in graphviz format, possibly compressed.
+ * @param graph the address where the graph is stored.
+ * @return true if the file was read.
+ * @return false if the file does not exist, or is compressed in an unsupported format, or its compressed data is corrupted (an error message is displayed).
+ */
+bool try_get_graph_from_file(char *toRead, Graph *graph);
+
+/**
+ * @brief Chooses whether the values of the parameters of the files parsed in place (mapped in memory) are interned while parsing, or kept as spans of the file and only interned the first time they are read.
+ *        In the latter mode, unused attributes (positions, colours...) cost no string, but each file stays mapped as long as its graph. Off by default.
+ * 
+ * @param lazy true to keep values as spans.
+ */
+void set_lazy_attributes(bool lazy);
+
+/**
+ * @brief Loads several files (in graphviz or snapshot format) concurrently, on a pool of threads.
+ * 
+ * @param files the names of the files.
+ * @param num_files the number of files.
+ * @param graphs the array where the graph of each file is stored.
+ * @param num_threads the maximal number of threads used (the calling thread included).
+ * @return true if all the files were loaded.
+ * @return false if some file could not be loaded (an error message is displayed). No graph is then stored.
+ */
+bool get_graphs_from_files(char **files, int num_files, Graph *graphs, int num_threads);
+
+/**
+ * @brief Parses a buffer with the flex/bison parser, feeding the statements to @p builder. The buffer is scanned in place.
+ * 
+ * @param buffer The characters to parse, followed by two null characters.
+ * @param size The number of characters (without the two null characters).
+ * @param builder An initialized builder.
+ * @return true if the buffer was parsed without error.
+ */
+bool parse_buffer(char *buffer, size_t size, GraphBuilder *builder);
+
+/**
+ * @brief A stream of concatenated graphs, read and parsed by a thread of its own while the graphs already parsed are used.
+ */
+typedef struct graphStream_s graphStream;
+
+/**
+ * @brief Starts reading a stream of concatenated graphs in graphviz format (e.g. several "digraph { ... }" blocks). Each graph is parsed as soon as its closing brace is read.
+ * 
+ * @param input The file containing the stream. It is not closed by the stream.
+ * @return graphStream* The stream, or NULL if its reading thread could not be started.
+ */
+graphStream *graph_stream_open(FILE *input);
+
+/**
+ * @brief Waits for the next graph of a stream. Graphs that could not be parsed are reported and skipped.
+ * 
+ * @param stream The stream.
+ * @param graph The address where the graph is stored. It belongs to the caller afterwards.
+ * @return true if a graph was stored.
+ * @return false if the end of the stream was reached.
+ */
+bool graph_stream_next(graphStream *stream, Graph *graph);
+
+/**
+ * @brief Stops reading a stream and frees it, with the graphs parsed but not yet obtained. Waits for the current read on the input to end.
+ * 
+ * @param stream The stream.
+ */
+void graph_stream_close(graphStream *stream);
+
 #endif
\ No newline at end of file
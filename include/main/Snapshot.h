@@ -0,0 +1,60 @@
+/**
+ * @file Snapshot.h
+ * @brief Compact binary format for parsed graphs. A snapshot stores the nodes, the compressed sparse row adjacency, the parameters (with their strings interned once)
+ *        and the precomputed tunnel network information of a graph. Loading maps the file in memory and uses its arrays in place, without any parsing: the strings, the adjacency, the name index,
+ *        the bit-packed adjacency and the actions of the nodes. Only the table of the names of the nodes, the parameter lists and the edge parameter table are built, in linear time, and
+ *        the strings of the parameters are interned (once per distinct string). No matrix of edges is built (see graph_is_edge).
+ *        Snapshots use the byte order and type sizes of the machine that wrote them: they are a cache of .dot files, not an exchange format.
+ * @version 1
+ * @date 2026-10-15
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#ifndef COCA_SNAPSHOT_H_
+#define COCA_SNAPSHOT_H_
+
+#include <stdbool.h>
+#include "Graph.h"
+
+/**
+ * @brief Writes @p graph in the file @p path in snapshot format.
+ *
+ * @param graph A graph.
+ * @param path The name of the file to write.
+ * @return true If the file was written.
+ * @return false If it could not be written.
+ * @pre @p graph must be a valid graph.
+ */
+bool snapshot_write(Graph graph, char *path);
+
+/**
+ * @brief Tells if the file @p path is a snapshot (by reading its first bytes).
+ *
+ * @param path The name of a file.
+ * @return true If @p path is a snapshot.
+ * @return false Otherwise (including if it cannot be read).
+ */
+bool snapshot_detect(char *path);
+
+/**
+ * @brief Loads the graph stored in the snapshot @p path, without exiting on errors. The file is mapped in memory, and stays mapped until the graph (and all its copies) are deleted.
+ *        Can be called from several threads at the same time.
+ *
+ * @param path The name of a snapshot file.
+ * @param graph The address where the graph is stored.
+ * @return true if the graph was loaded.
+ * @return false if the file does not exist or is not a valid snapshot (an error message is displayed).
+ */
+bool snapshot_try_load(char *path, Graph *graph);
+
+/**
+ * @brief Loads the graph stored in the snapshot @p path. The file is mapped in memory, and stays mapped until the graph (and all its copies) are deleted. Exits the program if the file is not a valid snapshot.
+ *
+ * @param path The name of a snapshot file.
+ * @return Graph The graph it contains.
+ */
+Graph snapshot_load(char *path);
+
+#endif
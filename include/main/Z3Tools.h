@@ -16,6 +16,8 @@
 
 #include <z3.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 /**
  * @brief Creates a basic Z3 context with basic config (sufficient for this project). Must be freed at end of program with Z3_del_context.
@@ -34,6 +36,123 @@ Z3_context make_context(void);
  */
 Z3_ast mk_bool_var(Z3_context ctx, const char *name);
 
+/**
+ * @brief A table of the variables of a reduction, grouped in families (e.g. the variables x_{node,pos,height}) indexed by at most 3 integer coordinates.
+ *        Each variable is created once, at its first use, and numbered by a counter: its id is its symbol (Z3_mk_int_symbol) instead of a formatted name. The table caches the id of
+ *        each variable in a flat array per family, indexed by its coordinates, and keeps the family and coordinates of each id, to decode models and name the variables.
+ *        A table is meant to be kept for all the formulae of a context (e.g. the formulae of a reduction for several bounds), so that they share their variables; two tables of the same
+ *        context would give the same symbols to different variables.
+ */
+typedef struct VariableTable_s *VariableTable;
+
+/**
+ * @brief A function writing the name of a variable of a family, given its coordinates.
+ */
+typedef void (*variableNamer)(char *name, size_t size, int coordinate_1, int coordinate_2, int coordinate_3);
+
+/**
+ * @brief Creates an empty table of variables. Must be freed with variable_table_delete.
+ *
+ * @param ctx The solver context, in which the variables are created.
+ * @return VariableTable The table.
+ */
+VariableTable variable_table_create(Z3_context ctx);
+
+/**
+ * @brief Adds a family of variables to a table. The sizes only reserve the cache of the family: it grows when a variable beyond them is created.
+ *
+ * @param table The table.
+ * @param namer The function writing the names of the variables.
+ * @param size_1 The expected number of values of the first coordinate.
+ * @param size_2 The expected number of values of the second coordinate (1 if unused).
+ * @param size_3 The expected number of values of the third coordinate (1 if unused).
+ * @return int The number of the family in @p table.
+ */
+int variable_table_add_family(VariableTable table, variableNamer namer, int size_1, int size_2, int size_3);
+
+/**
+ * @brief Returns the formula consisting in a variable of a table (created with the next id at the first call, then cached).
+ *
+ * @param table The table.
+ * @param family The number of the family of the variable.
+ * @param coordinate_1 Its first coordinate.
+ * @param coordinate_2 Its second coordinate (0 if unused).
+ * @param coordinate_3 Its third coordinate (0 if unused).
+ * @return Z3_ast The variable.
+ * @pre The coordinates must be non-negative.
+ */
+Z3_ast variable_table_get(VariableTable table, int family, int coordinate_1, int coordinate_2, int coordinate_3);
+
+/**
+ * @brief Reads the values of all the variables of a table in a model at once: walks the constants of the model, rather than evaluating each variable (see value_of_var_in_model).
+ *        The variables the model does not assign are false, as with value_of_var_in_model.
+ *
+ * @param table The table.
+ * @param model A variable assignment.
+ * @return uint64_t* A bitset with a bit per id of @p table, set if the variable is true. To read with variable_table_value, and free with free.
+ */
+uint64_t *variable_table_model_values(const VariableTable table, Z3_model model);
+
+/**
+ * @brief Returns the value of a variable of a table read by variable_table_model_values. A variable not created when the values were read is false.
+ *
+ * @param table The table.
+ * @param values The values read.
+ * @param family The number of the family of the variable.
+ * @param coordinate_1 Its first coordinate.
+ * @param coordinate_2 Its second coordinate (0 if unused).
+ * @param coordinate_3 Its third coordinate (0 if unused).
+ * @return true if the variable is true in the model.
+ * @pre The coordinates must be non-negative.
+ */
+bool variable_table_value(const VariableTable table, const uint64_t *values, int family, int coordinate_1, int coordinate_2, int coordinate_3);
+
+/**
+ * @brief Returns a formula where every variable created in a table is replaced by a variable named after its family and coordinates (see mk_bool_var), to print it.
+ *        Substitutes all the variables of the table at once, whether they occur in @p formula or not.
+ *
+ * @param table The table.
+ * @param formula A formula.
+ * @return Z3_ast The formula with named variables.
+ */
+Z3_ast variable_table_readable(VariableTable table, Z3_ast formula);
+
+/**
+ * @brief Frees a table of variables (the variables stay valid in their context).
+ *
+ * @param table The table.
+ */
+void variable_table_delete(VariableTable table);
+
+/**
+ * @brief The encodings of the constraint "at most one of the formulae is true", used by at_most_formula and uniqueFormula. The pairwise encoding needs a quadratic number of clauses, the next ones a linear or quasi-linear one, with auxiliary variables, and the native one none.
+ */
+typedef enum
+{
+    at_most_one_auto,       ///< Pairwise for at most 6 formulae, sequential for at most 4096, commander beyond.
+    at_most_one_pairwise,   ///< One clause per pair of formulae: n(n-1)/2 clauses, no auxiliary variable.
+    at_most_one_sequential, ///< Sequential counter: 3n-4 clauses, n-1 auxiliary variables.
+    at_most_one_commander,  ///< Commanders of groups of 3, recursively: about 3.5n clauses, n/2 auxiliary variables.
+    at_most_one_bimander,   ///< Binary numbering of pairs: about n log2(n) clauses, log2(n) auxiliary variables.
+    at_most_one_native      ///< No clauses: a cardinality constraint of Z3 (Z3_mk_atmost), handled natively by its SAT core.
+} atMostOneEncoding;
+
+/**
+ * @brief Chooses the encoding of the formulae generated afterwards by at_most_formula and uniqueFormula. at_most_one_auto by default.
+ *
+ * @param encoding The encoding.
+ */
+void set_at_most_one_encoding(atMostOneEncoding encoding);
+
+/**
+ * @brief Finds an encoding from its name: "auto", "pairwise", "sequential", "commander", "bimander" or "native".
+ *
+ * @param name The name.
+ * @param encoding The address where the encoding is stored.
+ * @return true if @p name is the name of an encoding.
+ */
+bool at_most_one_encoding_from_name(const char *name, atMostOneEncoding *encoding);
+
 /**
  * @brief Generates a formula stating that at most one of the formulae from @p formulae is true.
  *
@@ -54,6 +173,98 @@ Z3_ast at_most_formula(Z3_context ctx, Z3_ast *formulae, int size);
  */
 Z3_ast uniqueFormula(Z3_context ctx, Z3_ast *formulae, int size);
 
+/**
+ * @brief A solver kept between several checks. Constraints are added incrementally, possibly in scopes (push/pop), and each check can assume some literals,
+ *        so that what the solver learned for the previous checks is reused by the next ones.
+ */
+typedef struct SolverSession_s *SolverSession;
+
+/**
+ * @brief Creates a solver session, without constraints. Must be freed with solver_session_delete.
+ *
+ * @param ctx The context of the solver.
+ * @return SolverSession The session.
+ */
+SolverSession solver_session_create(Z3_context ctx);
+
+/**
+ * @brief Adds a constraint to a session. It stays until the current scope is popped.
+ *
+ * @param session The session.
+ * @param constraint The constraint.
+ */
+void solver_session_add(SolverSession session, Z3_ast constraint);
+
+/**
+ * @brief Adds a constraint to a session that only holds in the checks assuming the literal returned (its activation literal), until it is retracted with solver_session_retract.
+ *        Unlike a scope, it can be retracted while the constraints added after it stay, and what the solver learned from it stays valid (guarded by the literal).
+ *
+ * @param session The session.
+ * @param constraint The constraint.
+ * @return Z3_ast The activation literal of @p constraint, to assume in solver_session_check.
+ */
+Z3_ast solver_session_add_retractable(SolverSession session, Z3_ast constraint);
+
+/**
+ * @brief Retracts for good a constraint added with solver_session_add_retractable (its activation literal becomes false), so that the solver can discard it.
+ *
+ * @param session The session.
+ * @param activation The activation literal of the constraint.
+ */
+void solver_session_retract(SolverSession session, Z3_ast activation);
+
+/**
+ * @brief Opens a scope: the constraints added afterwards are removed by the matching solver_session_pop.
+ *
+ * @param session The session.
+ */
+void solver_session_push(SolverSession session);
+
+/**
+ * @brief Closes scopes, removing the constraints added since they were opened.
+ *
+ * @param session The session.
+ * @param num_scopes The number of scopes closed.
+ * @pre At least @p num_scopes scopes must be open.
+ */
+void solver_session_pop(SolverSession session, int num_scopes);
+
+/**
+ * @brief Tells if the constraints of a session, and the assumed literals, are satisfiable. The assumptions only hold for this check.
+ *
+ * @param session The session.
+ * @param num_assumptions The number of assumed literals.
+ * @param assumptions The literals (variables or their negations).
+ * @return Z3_lbool Z3_L_FALSE if unsatisfiable, Z3_L_TRUE if satisfiable and Z3_L_UNDEF if the solver cannot decide.
+ */
+Z3_lbool solver_session_check(SolverSession session, int num_assumptions, Z3_ast *assumptions);
+
+/**
+ * @brief Returns a model of the constraints of a session and the assumptions of its last check.
+ *
+ * @param session The session.
+ * @return Z3_model The model.
+ * @pre The last check of @p session must have returned Z3_L_TRUE (or Z3_L_UNDEF, for a partial model).
+ */
+Z3_model solver_session_get_model(SolverSession session);
+
+/**
+ * @brief Returns the assumptions of the last check of a session that suffice to make it unsatisfiable (an unsat core).
+ *
+ * @param session The session.
+ * @param core The array where the assumptions are stored. Must have room for all the assumptions of the last check.
+ * @return int The number of assumptions stored.
+ * @pre The last check of @p session must have returned Z3_L_FALSE.
+ */
+int solver_session_get_core(SolverSession session, Z3_ast *core);
+
+/**
+ * @brief Frees a solver session. The models obtained from it stay valid.
+ *
+ * @param session The session.
+ */
+void solver_session_delete(SolverSession session);
+
 /**
  * @brief Tells if a formula is satisfiable, unsatisfiable, or cannot be decided.
  * 
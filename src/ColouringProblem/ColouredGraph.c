@@ -8,8 +8,10 @@
 
 struct ColouredGraph_s
 {
-    Graph graph;  ///< The graph.
-    int *colours; ///< The colours associated to each node.
+    Graph graph;              ///< The graph.
+    int *colours;             ///< The colours associated to each node.
+    uint64_t **colour_nodes;  ///< For each colour, the bitset of the nodes having it (only if the graph has a bit-packed adjacency).
+    int num_colour_sets;      ///< The number of bitsets in colour_nodes.
 };
 
 ColouredGraph cg_initialize(Graph graph)
@@ -20,6 +22,8 @@ ColouredGraph cg_initialize(Graph graph)
     result->colours = (int *)malloc(num_nodes * sizeof(int));
     for (int node = 0; node < num_nodes; node++)
         result->colours[node] = -1;
+    result->colour_nodes = NULL;
+    result->num_colour_sets = 0;
     return result;
 }
 
@@ -40,10 +44,19 @@ void cg_print_colors(ColouredGraph graph)
 
 void cg_delete(ColouredGraph graph)
 {
+    for (int col = 0; col < graph->num_colour_sets; col++)
+        free(graph->colour_nodes[col]);
+    free(graph->colour_nodes);
     free(graph->colours);
     free(graph);
 }
 
+size_t cg_memory_usage(ColouredGraph graph)
+{
+    size_t num_nodes = graph_num_nodes(graph->graph);
+    return sizeof(*graph) + num_nodes * sizeof(int) + graph->num_colour_sets * (sizeof(uint64_t *) + bitset_num_words(num_nodes) * sizeof(uint64_t));
+}
+
 int cg_get_num_nodes(ColouredGraph graph)
 {
     return graph_num_nodes(graph->graph);
@@ -59,6 +72,11 @@ bool cg_is_edge(ColouredGraph graph, int source, int target)
     return (graph_is_edge(graph->graph, source, target));
 }
 
+size_t cg_get_neighbours(ColouredGraph graph, int node, const int **neighbours)
+{
+    return graph_out_neighbours(graph->graph, node, neighbours);
+}
+
 char *cg_get_node_name(ColouredGraph graph, int node)
 {
     return graph_get_node_name(graph->graph, node);
@@ -71,9 +89,45 @@ int cg_get_node_colour(ColouredGraph graph, int node)
 
 void cg_set_node_colour(ColouredGraph graph, int node, int colour)
 {
+    if (graph_has_edge_bits(graph->graph))
+    {
+        int old_colour = graph->colours[node];
+        if (old_colour >= 0)
+            bitset_clear(graph->colour_nodes[old_colour], node);
+        if (colour >= graph->num_colour_sets)
+        {
+            graph->colour_nodes = (uint64_t **)realloc(graph->colour_nodes, (colour + 1) * sizeof(uint64_t *));
+            for (int col = graph->num_colour_sets; col <= colour; col++)
+                graph->colour_nodes[col] = bitset_create(graph_num_nodes(graph->graph));
+            graph->num_colour_sets = colour + 1;
+        }
+        if (colour >= 0)
+            bitset_set(graph->colour_nodes[colour], node);
+    }
     graph->colours[node] = colour;
 }
 
+bool cg_neighbour_has_colour(ColouredGraph graph, int node, int colour)
+{
+    if (graph_has_edge_bits(graph->graph))
+    {
+        if (colour < 0 || colour >= graph->num_colour_sets)
+            return false;
+        return bitset_intersects(graph_edge_bits_row(graph->graph, node), graph->colour_nodes[colour], graph_edge_bits_words(graph->graph));
+    }
+    const int *neighbours;
+    size_t degree = cg_get_neighbours(graph, node, &neighbours);
+    for (size_t i = 0; i < degree; i++)
+        if (graph->colours[neighbours[i]] == colour)
+            return true;
+    return false;
+}
+
+int cg_clique_lower_bound(ColouredGraph graph)
+{
+    return graph_greedy_clique_size(graph->graph);
+}
+
 void cg_create_dot(ColouredGraph graph, char *name)
 {
 
@@ -154,13 +208,12 @@ void cg_create_dot(ColouredGraph graph, char *name)
 
     for (int node = 0; node < num_nodes; node++)
     {
-        for (int node2 = 0; node2 < node; node2++)
+        const int *neighbours;
+        size_t degree = cg_get_neighbours(graph, node, &neighbours);
+        for (size_t i = 0; i < degree && neighbours[i] < node; i++)
         {
-            if (graph_is_edge(graph->graph, node, node2))
-            {
-                fprintf(file, "%s -- %s", graph_get_node_name(graph->graph, node), graph_get_node_name(graph->graph, node2));
-                fprintf(file, ";\n");
-            }
+            fprintf(file, "%s -- %s", graph_get_node_name(graph->graph, node), graph_get_node_name(graph->graph, neighbours[i]));
+            fprintf(file, ";\n");
         }
     }
 
@@ -8,37 +8,97 @@
 #include <assert.h>
 
 /**
- * @brief Creates a formula containing only the variable representing that node @p node has color @p color.
+ * @brief The variables of the reduction, in the table of colouring_variable_table_create (see VariableTable).
+ */
+typedef struct
+{
+    VariableTable table; ///< The table of the variables.
+    int node_colour;     ///< The family of the variables stating that a node has a colour.
+} colouringVariables;
+
+/**
+ * @brief Writes the name of the variable stating that node @p node has colour @p colour (see variableNamer).
+ *
+ * @param name Where the name is written.
+ * @param size The room in @p name.
+ * @param node A node.
+ * @param colour A colour.
+ * @param unused Unused (the family has two coordinates).
+ */
+void node_colour_variable_name(char *name, size_t size, int node, int colour, int unused)
+{
+    snprintf(name, size, "node %d, color %d", node, colour);
+}
+
+/**
+ * @brief The family of the variables stating that a node has a colour in the tables of colouring_variable_table_create.
+ */
+#define COLOURING_NODE_COLOUR_FAMILY 0
+
+VariableTable colouring_variable_table_create(Z3_context ctx, const ColouredGraph graph)
+{
+    VariableTable table = variable_table_create(ctx);
+    variable_table_add_family(table, node_colour_variable_name, cg_get_num_nodes(graph), 4, 1);
+    return table;
+}
+
+/**
+ * @brief Gives the family of the variables of the reduction in @p table.
+ *
+ * @param table A table created by colouring_variable_table_create.
+ * @return colouringVariables The variables.
+ */
+colouringVariables colouring_variables(VariableTable table)
+{
+    colouringVariables variables = {table, COLOURING_NODE_COLOUR_FAMILY};
+    return variables;
+}
+
+/**
+ * @brief Returns a formula containing only the variable representing that node @p node has color @p color.
  * 
- * @param ctx The solver context.
+ * @param variables The variables of the reduction.
  * @param node A node.
  * @param color A color.
  * @return Z3_ast 
  */
-Z3_ast variable_node_color(Z3_context ctx, int node, int color)
+Z3_ast variable_node_color(const colouringVariables *variables, int node, int color)
 {
-    char name[40];
-    snprintf(name, 40, "node %d, color %d", node, color);
-    return mk_bool_var(ctx, name);
+    return variable_table_get(variables->table, variables->node_colour, node, color, 0);
+}
+
+/**
+ * @brief Tells if the variable representing that node @p node has color @p color is true in values read from a model (see variable_table_model_values).
+ *
+ * @param variables The variables of the reduction.
+ * @param values The values of the variables.
+ * @param node A node.
+ * @param color A color.
+ * @return bool
+ */
+bool value_node_color(const colouringVariables *variables, const uint64_t *values, int node, int color)
+{
+    return variable_table_value(variables->table, values, variables->node_colour, node, color, 0);
 }
 
 /**
  * @brief Creates the formula stating that the edge (@p node1,@p node2) has its ends of different colours.
  * 
  * @param ctx The solver context.
+ * @param variables The variables of the reduction.
  * @param node1 A node.
  * @param node2 A node.
  * @param num_colours The expected number of colours.
  * @return Z3_ast The formula.
  */
-Z3_ast edge_formula(Z3_context ctx, int node1, int node2, int num_colours)
+Z3_ast edge_formula(Z3_context ctx, const colouringVariables *variables, int node1, int node2, int num_colours)
 {
     Z3_ast edge_diff[num_colours];
     for (int colour = 0; colour < num_colours; colour++)
     {
         Z3_ast col_diff[2];
-        col_diff[0] = Z3_mk_not(ctx, variable_node_color(ctx, node1, colour));
-        col_diff[1] = Z3_mk_not(ctx, variable_node_color(ctx, node2, colour));
+        col_diff[0] = Z3_mk_not(ctx, variable_node_color(variables, node1, colour));
+        col_diff[1] = Z3_mk_not(ctx, variable_node_color(variables, node2, colour));
         edge_diff[colour] = Z3_mk_or(ctx, 2, col_diff);
     }
     return Z3_mk_and(ctx, num_colours, edge_diff);
@@ -48,37 +108,49 @@ Z3_ast edge_formula(Z3_context ctx, int node1, int node2, int num_colours)
  * @brief Creates the formula stating that all edges have their ends of different colours.
  * 
  * @param ctx The solver context.
+ * @param variables The variables of the reduction.
  * @param graph A ColouredGraph.
  * @param num_colours The expected number of colours.
  * @return Z3_ast The formula.
  */
-Z3_ast edges_have_different_colours_formula(Z3_context ctx, const ColouredGraph graph, int num_colours)
+Z3_ast edges_have_different_colours_formula(Z3_context ctx, const colouringVariables *variables, const ColouredGraph graph, int num_colours)
 {
     int num_nodes = cg_get_num_nodes(graph);
-    int current = 0;
-    Z3_ast edges_formula[num_nodes * num_nodes];
+    size_t num_adjacent = 0;
+    for (int node = 0; node < num_nodes; node++)
+    {
+        const int *neighbours;
+        num_adjacent += cg_get_neighbours(graph, node, &neighbours);
+    }
+    size_t current = 0;
+    Z3_ast *edges_formula = (Z3_ast *)malloc((num_adjacent + 1) * sizeof(Z3_ast));
     for (int node1 = 0; node1 < num_nodes; node1++)
     {
-        for (int node2 = node1 + 1; node2 < num_nodes; node2++)
+        const int *neighbours;
+        size_t degree = cg_get_neighbours(graph, node1, &neighbours);
+        for (size_t i = 0; i < degree; i++)
         {
-            if (!cg_is_edge(graph, node1, node2))
+            if (neighbours[i] <= node1)
                 continue;
-            edges_formula[current] = edge_formula(ctx, node1, node2, num_colours);
+            edges_formula[current] = edge_formula(ctx, variables, node1, neighbours[i], num_colours);
             current++;
         }
     }
-    return Z3_mk_and(ctx, current, edges_formula);
+    Z3_ast result = Z3_mk_and(ctx, current, edges_formula);
+    free(edges_formula);
+    return result;
 }
 
 /**
  * @brief Creates a formula stating that every node has exactly one colour.
  * 
  * @param ctx The solver context.
+ * @param variables The variables of the reduction.
  * @param num_nodes The number of nodes.
  * @param num_colours The expected number of colours.
  * @return Z3_ast The formula.
  */
-Z3_ast each_node_has_one_colour_formula(Z3_context ctx, int num_nodes, int num_colours)
+Z3_ast each_node_has_one_colour_formula(Z3_context ctx, const colouringVariables *variables, int num_nodes, int num_colours)
 {
 
     Z3_ast nodes_coloured[num_nodes];
@@ -87,42 +159,54 @@ Z3_ast each_node_has_one_colour_formula(Z3_context ctx, int num_nodes, int num_c
         Z3_ast node_color_vars[num_colours];
         for (int colour = 0; colour < num_colours; colour++)
         {
-            node_color_vars[colour] = variable_node_color(ctx, node, colour);
+            node_color_vars[colour] = variable_node_color(variables, node, colour);
         }
         nodes_coloured[node] = uniqueFormula(ctx, node_color_vars, num_colours);
     }
     return Z3_mk_and(ctx, num_nodes, nodes_coloured);
 }
 
-Z3_ast colouring_reduction(Z3_context ctx, const ColouredGraph graph, int num_colours)
+Z3_ast colouring_reduction(Z3_context ctx, VariableTable table, const ColouredGraph graph, int num_colours)
 {
     int num_nodes = cg_get_num_nodes(graph);
+    colouringVariables variables = colouring_variables(table);
     Z3_ast result[2];
-    result[0] = edges_have_different_colours_formula(ctx, graph, num_colours);
-    result[1] = each_node_has_one_colour_formula(ctx, num_nodes, num_colours);
+    result[0] = edges_have_different_colours_formula(ctx, &variables, graph, num_colours);
+    result[1] = each_node_has_one_colour_formula(ctx, &variables, num_nodes, num_colours);
     return Z3_mk_and(ctx, 2, result);
 }
 
-void colour_graph_from_model(Z3_context ctx, Z3_model model, ColouredGraph graph, int num_colours)
+Z3_ast colouring_readable_formula(Z3_context ctx, VariableTable table, Z3_ast formula)
+{
+    return variable_table_readable(table, formula);
+}
+
+void colour_graph_from_model(Z3_context ctx, VariableTable table, Z3_model model, ColouredGraph graph, int num_colours)
 {
     int num_nodes = cg_get_num_nodes(graph);
+    colouringVariables variables = colouring_variables(table);
+    uint64_t *values = variable_table_model_values(table, model);
     for (int node = 0; node < num_nodes; node++)
     {
         for (int colour = 0; colour < num_colours; colour++)
         {
-            if (value_of_var_in_model(ctx, model, variable_node_color(ctx, node, colour)))
+            if (value_node_color(&variables, values, node, colour))
             {
                 cg_set_node_colour(graph, node, colour);
                 break;
             }
         }
     }
+    free(values);
 }
 
-void colouring_print_model(Z3_context ctx, Z3_model model, ColouredGraph graph, int num_colours)
+void colouring_print_model(Z3_context ctx, VariableTable table, Z3_model model, ColouredGraph graph, int num_colours)
 {
     int num_nodes = cg_get_num_nodes(graph);
+    colouringVariables variables = colouring_variables(table);
+    uint64_t *values = variable_table_model_values(table, model);
     for (int node = 0; node < num_nodes; node++)
         for (int colour = 0; colour < num_colours; colour++)
-            printf("[%d:%d] = %d\n", node, colour, value_of_var_in_model(ctx, model, variable_node_color(ctx, node, colour)));
+            printf("[%d:%d] = %d\n", node, colour, value_node_color(&variables, values, node, colour));
+    free(values);
 }
\ No newline at end of file
@@ -20,21 +20,10 @@ bool recursive_bf(ColouredGraph graph, int num_colours, int node)
         return true;
     for (int col = 0; col < num_colours; col++)
     {
-        cg_set_node_colour(graph, node, col);
-        bool same_colour_as_neighbour = false;
-        for (int n = 0; n < node; n++)
-        {
-            if (!cg_is_edge(graph, node, n))
-                continue;
-            int col_n = cg_get_node_colour(graph, n);
-            if (col_n == col)
-            {
-                same_colour_as_neighbour = true;
-                break;
-            }
-        }
-        if (same_colour_as_neighbour)
+        // Nodes greater than node are not coloured, and node itself does not have colour col yet: self-loops are ignored.
+        if (cg_neighbour_has_colour(graph, node, col))
             continue;
+        cg_set_node_colour(graph, node, col);
         bool res = recursive_bf(graph, num_colours, node + 1);
         if (res)
             return true;
@@ -47,5 +36,7 @@ bool recursive_bf(ColouredGraph graph, int num_colours, int node)
 
 bool colouring_brute_force(ColouredGraph graph, int num_colours)
 {
+    if (cg_clique_lower_bound(graph) > num_colours)
+        return false;
     return recursive_bf(graph, num_colours, 0);
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "TunnelNetwork.h"
+#include "LabelDecoder.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/types.h>
@@ -22,56 +23,45 @@ TunnelNetwork tn_initialize(Graph graph)
     result->node_actions = (int *)malloc(num_nodes * sizeof(int));
     result->initial = 0; // dummy value
     result->final = 0;   // dummy value
+    const int *node_actions = graph_get_node_actions(graph);
+    if (node_actions != NULL)
+    {
+        // Decoded while the graph was built (or loaded from a snapshot): no label to process.
+        memcpy(result->node_actions, node_actions, num_nodes * sizeof(int));
+        result->initial = graph_get_initial(graph);
+        result->final = graph_get_final(graph);
+        return result;
+    }
+    // Undirected graphs, and snapshots written without the actions.
+    atom shape = atom_intern("shape");
+    atom square = atom_intern("square");
+    atom invtriangle = atom_intern("invtriangle");
+    atom label = atom_intern("label");
+    labelDecoder decoder;
+    label_decoder_init(&decoder);
     for (int node = 0; node < num_nodes; node++)
     {
-        char *param = parameter_list_get_value(graph_get_node_parameter(graph, node), "shape");
-        if (param != NULL)
-        {
-            if (strcmp("square", param) == 0)
-                result->initial = node;
-            if (strcmp("invtriangle", param) == 0)
-                result->final = node;
-        }
-        char *actions = parameter_list_get_value(graph_get_node_parameter(graph, node), "label");
-        if (actions == NULL)
-            continue;
-        char work[strlen(actions) + 1];
-        strcpy(work, actions);
-        const char delim[] = "\\n\"";
-        char *lex = NULL;
-        char *token = strtok_r(work, delim, &lex);
-        result->node_actions[node] = 0;
-        while (token != NULL)
-        {
-            if (strcmp(token, "4→4") == 0)
-                result->node_actions[node] += 1 << transmit_4;
-            if (strcmp(token, "6→6") == 0)
-                result->node_actions[node] += 1 << transmit_6;
-            if (strcmp(token, "4↑44") == 0)
-                result->node_actions[node] += 1 << push_4_4;
-            if (strcmp(token, "4↑46") == 0)
-                result->node_actions[node] += 1 << push_4_6;
-            if (strcmp(token, "6↑64") == 0)
-                result->node_actions[node] += 1 << push_6_4;
-            if (strcmp(token, "6↑66") == 0)
-                result->node_actions[node] += 1 << push_6_6;
-            if (strcmp(token, "44↓4") == 0)
-                result->node_actions[node] += 1 << pop_4_4;
-            if (strcmp(token, "46↓4") == 0)
-                result->node_actions[node] += 1 << pop_4_6;
-            if (strcmp(token, "64↓6") == 0)
-                result->node_actions[node] += 1 << pop_6_4;
-            if (strcmp(token, "66↓6") == 0)
-                result->node_actions[node] += 1 << pop_6_6;
-
-            token = strtok_r(NULL, delim, &lex);
-        }
+        atom param = graph_get_node_attribute(graph, node, shape);
+        if (param == square)
+            result->initial = node;
+        if (param == invtriangle)
+            result->final = node;
+        result->node_actions[node] = label_decoder_actions(&decoder, graph_get_node_attribute(graph, node, label));
     }
-    // todo: fill node_actions.
 
     return result;
 }
 
+void tn_store_node_actions(TunnelNetwork network, Graph *graph)
+{
+    graph_set_node_actions(graph, network->node_actions, network->initial, network->final);
+}
+
+size_t tn_memory_usage(TunnelNetwork network)
+{
+    return sizeof(*network) + tn_get_num_nodes(network) * sizeof(int);
+}
+
 void tn_delete(TunnelNetwork network)
 {
     free(network->node_actions);
@@ -139,6 +129,36 @@ bool tn_is_edge(TunnelNetwork network, int source, int target)
     return graph_is_edge(network->graph, source, target);
 }
 
+size_t tn_out_neighbours(TunnelNetwork network, int node, const int **neighbours)
+{
+    return graph_out_neighbours(network->graph, node, neighbours);
+}
+
+size_t tn_in_neighbours(TunnelNetwork network, int node, const int **neighbours)
+{
+    return graph_in_neighbours(network->graph, node, neighbours);
+}
+
+size_t tn_out_degree(TunnelNetwork network, int node)
+{
+    return graph_out_degree(network->graph, node);
+}
+
+size_t tn_in_degree(TunnelNetwork network, int node)
+{
+    return graph_in_degree(network->graph, node);
+}
+
+int tn_reachable_from_initial(TunnelNetwork network, bool *reached)
+{
+    return graph_reachable(network->graph, network->initial, reached);
+}
+
+int tn_coreachable_to_final(TunnelNetwork network, bool *reached)
+{
+    return graph_coreachable(network->graph, network->final, reached);
+}
+
 char *tn_get_node_name(TunnelNetwork network, int node)
 {
     return graph_get_node_name(network->graph, node);
@@ -1,69 +1,175 @@
 #include "TunnelReduction.h"
 #include "Z3Tools.h"
 #include "stdio.h"
+#include <stdlib.h>
 
 /**
- * @brief Creates the variable "x_{node,pos,stack_height}" of the reduction (described in the subject).
+ * @brief Wrapper to have the correct size of the array representing the stack (correct cells of the stack will be from 0 to (get_stack_size(length)-1)).
+ *
+ * @param length The length of the sought path.
+ * @return int
+ */
+int get_stack_size(int length)
+{
+    return length / 2 + 1;
+}
+
+/**
+ * @brief The variables of the reduction, in the table of tn_variable_table_create (see VariableTable).
+ */
+typedef struct
+{
+    VariableTable table; ///< The table of the variables.
+    int path;            ///< The family of the variables x_{node,pos,height}, of coordinates (node,pos,height).
+    int cell;            ///< The family of the variables y_{pos,height,4} and y_{pos,height,6}, of coordinates (0 for 4 or 1 for 6,pos,height).
+} tnVariables;
+
+/**
+ * @brief The family of the variables x_{node,pos,height} in the tables of tn_variable_table_create.
+ */
+#define TN_PATH_FAMILY 0
+
+/**
+ * @brief The family of the variables y_{pos,height,4} and y_{pos,height,6} in the tables of tn_variable_table_create.
+ */
+#define TN_CELL_FAMILY 1
+
+/**
+ * @brief Writes the name of the variable x_{node,pos,height} (see variableNamer).
  *
- * @param ctx The solver context.
+ * @param name Where the name is written.
+ * @param size The room in @p name.
+ * @param node A node.
+ * @param pos The path position.
+ * @param height The highest cell occupied of the stack at that position.
+ */
+void tn_path_variable_name(char *name, size_t size, int node, int pos, int height)
+{
+    snprintf(name, size, "node %d,pos %d, height %d", node, pos, height);
+}
+
+/**
+ * @brief Writes the name of the variable y_{pos,height,4} or y_{pos,height,6} (see variableNamer).
+ *
+ * @param name Where the name is written.
+ * @param size The room in @p name.
+ * @param protocol 0 for y_{pos,height,4}, 1 for y_{pos,height,6}.
+ * @param pos The path position.
+ * @param height The height of the cell described.
+ */
+void tn_cell_variable_name(char *name, size_t size, int protocol, int pos, int height)
+{
+    snprintf(name, size, "%d at height %d on pos %d", protocol == 0 ? 4 : 6, height, pos);
+}
+
+VariableTable tn_variable_table_create(Z3_context ctx, const TunnelNetwork network)
+{
+    VariableTable table = variable_table_create(ctx);
+    variable_table_add_family(table, tn_path_variable_name, tn_get_num_nodes(network), 2, 1);
+    variable_table_add_family(table, tn_cell_variable_name, 2, 2, 1);
+    return table;
+}
+
+/**
+ * @brief Gives the families of the variables of the reduction in @p table.
+ *
+ * @param table A table created by tn_variable_table_create.
+ * @return tnVariables The variables.
+ */
+tnVariables tn_variables(VariableTable table)
+{
+    tnVariables variables = {table, TN_PATH_FAMILY, TN_CELL_FAMILY};
+    return variables;
+}
+
+/**
+ * @brief Returns the variable "x_{node,pos,stack_height}" of the reduction (described in the subject).
+ *
+ * @param variables The variables of the reduction.
  * @param node A node.
  * @param pos The path position.
  * @param stack_height The highest cell occupied of the stack at that position.
  * @return Z3_ast
  */
-Z3_ast tn_path_variable(Z3_context ctx, int node, int pos, int stack_height)
+Z3_ast tn_path_variable(const tnVariables *variables, int node, int pos, int stack_height)
 {
-    char name[60];
-    snprintf(name, 60, "node %d,pos %d, height %d", node, pos, stack_height);
-    return mk_bool_var(ctx, name);
+    return variable_table_get(variables->table, variables->path, node, pos, stack_height);
 }
 
 /**
- * @brief Creates the variable "y_{pos,height,4}" of the reduction (described in the subject).
+ * @brief Returns the variable "y_{pos,height,4}" of the reduction (described in the subject).
  *
- * @param ctx The solver context.
+ * @param variables The variables of the reduction.
  * @param pos The path position.
  * @param height The height of the cell described.
  * @return Z3_ast
  */
-Z3_ast tn_4_variable(Z3_context ctx, int pos, int height)
+Z3_ast tn_4_variable(const tnVariables *variables, int pos, int height)
 {
-    char name[60];
-    snprintf(name, 60, "4 at height %d on pos %d", height, pos);
-    return mk_bool_var(ctx, name);
+    return variable_table_get(variables->table, variables->cell, 0, pos, height);
 }
 
 /**
- * @brief Creates the variable "y_{pos,height,6}" of the reduction (described in the subject).
+ * @brief Returns the variable "y_{pos,height,6}" of the reduction (described in the subject).
  *
- * @param ctx The solver context.
+ * @param variables The variables of the reduction.
  * @param pos The path position.
  * @param height The height of the cell described.
  * @return Z3_ast
  */
-Z3_ast tn_6_variable(Z3_context ctx, int pos, int height)
+Z3_ast tn_6_variable(const tnVariables *variables, int pos, int height)
 {
-    char name[60];
-    snprintf(name, 60, "6 at height %d on pos %d", height, pos);
-    return mk_bool_var(ctx, name);
+    return variable_table_get(variables->table, variables->cell, 1, pos, height);
 }
 
 /**
- * @brief Wrapper to have the correct size of the array representing the stack (correct cells of the stack will be from 0 to (get_stack_size(length)-1)).
+ * @brief Tells if the variable "x_{node,pos,stack_height}" is true in values read from a model (see variable_table_model_values).
  *
- * @param length The length of the sought path.
- * @return int
+ * @param variables The variables of the reduction.
+ * @param values The values of the variables.
+ * @param node A node.
+ * @param pos The path position.
+ * @param stack_height The highest cell occupied of the stack at that position.
+ * @return bool
  */
-int get_stack_size(int length)
+bool tn_path_value(const tnVariables *variables, const uint64_t *values, int node, int pos, int stack_height)
 {
-    return length / 2 + 1;
+    return variable_table_value(variables->table, values, variables->path, node, pos, stack_height);
+}
+
+/**
+ * @brief Tells if the variable "y_{pos,height,4}" is true in values read from a model (see variable_table_model_values).
+ *
+ * @param variables The variables of the reduction.
+ * @param values The values of the variables.
+ * @param pos The path position.
+ * @param height The height of the cell described.
+ * @return bool
+ */
+bool tn_4_value(const tnVariables *variables, const uint64_t *values, int pos, int height)
+{
+    return variable_table_value(variables->table, values, variables->cell, 0, pos, height);
+}
+
+/**
+ * @brief Tells if the variable "y_{pos,height,6}" is true in values read from a model (see variable_table_model_values).
+ *
+ * @param variables The variables of the reduction.
+ * @param values The values of the variables.
+ * @param pos The path position.
+ * @param height The height of the cell described.
+ * @return bool
+ */
+bool tn_6_value(const tnVariables *variables, const uint64_t *values, int pos, int height)
+{
+    return variable_table_value(variables->table, values, variables->cell, 1, pos, height);
 }
 
 /** 
  * @brief Créer la formule φ1
  */
 
-Z3_ast create_phi_1(Z3_context ctx, const TunnelNetwork network, int length)
+Z3_ast create_phi_1(Z3_context ctx, const TunnelNetwork network, int length, const tnVariables *variables)
 {
    //Récupérer le nombre de noeuds dans le réseau
    int num_nodes = tn_get_num_nodes(network);
@@ -78,7 +184,7 @@ Z3_ast create_phi_1(Z3_context ctx, const TunnelNetwork network, int length)
   {
     // Calculer le nombre de vars pour cette position
     int num_variables = num_nodes * stack_size;
-    Z3_ast variables[num_variables]; 
+    Z3_ast pos_variables[num_variables]; 
 
     int var_index = 0;
 
@@ -89,12 +195,12 @@ Z3_ast create_phi_1(Z3_context ctx, const TunnelNetwork network, int length)
      for (int height = 0; height < stack_size; height++)
     {
         // Créer la variable x{node, pos, height}
-        variables[var_index] = tn_path_variable(ctx, node, pos, height);
+        pos_variables[var_index] = tn_path_variable(variables, node, pos, height);
         var_index++;  
     } 
    } 
    //uniqueFormula = exactement une des vars du tab est vraie
-    phi_1_conjuncts[pos] = uniqueFormula(ctx, variables, num_variables); 
+    phi_1_conjuncts[pos] = uniqueFormula(ctx, pos_variables, num_variables); 
   } 
    //Faire la conjonction de toutes des formules Unique
    return Z3_mk_and(ctx, length + 1, phi_1_conjuncts);
@@ -104,7 +210,7 @@ Z3_ast create_phi_1(Z3_context ctx, const TunnelNetwork network, int length)
  * Créer φ2 exprimant les conditions initiales et fianles
 */
 
-Z3_ast create_phi_2(Z3_context ctx, const TunnelNetwork network, int length)
+Z3_ast create_phi_2(Z3_context ctx, const TunnelNetwork network, int length, const tnVariables *variables)
 {
     // Récupérer le noeud source
     int source = tn_get_initial(network);
@@ -113,19 +219,19 @@ Z3_ast create_phi_2(Z3_context ctx, const TunnelNetwork network, int length)
     int destination = tn_get_final(network);
 
     // x{source,0,0} 
-    Z3_ast x_initial = tn_path_variable(ctx, source, 0, 0);
+    Z3_ast x_initial = tn_path_variable(variables, source, 0, 0);
     
     // y{0,0,4}
-    Z3_ast y_initial = tn_4_variable(ctx, 0, 0);
+    Z3_ast y_initial = tn_4_variable(variables, 0, 0);
     
     Z3_ast phi_2_initial_parts[2] = {x_initial, y_initial};
     Z3_ast phi_2_initial = Z3_mk_and(ctx, 2, phi_2_initial_parts);
     
     // x{dest, length,0}
-    Z3_ast x_final = tn_path_variable(ctx, destination, length, 0);
+    Z3_ast x_final = tn_path_variable(variables, destination, length, 0);
     
     // y{length,0,4}
-    Z3_ast y_final = tn_4_variable(ctx, length, 0); 
+    Z3_ast y_final = tn_4_variable(variables, length, 0); 
 
     Z3_ast phi_2_final_parts[2] = {x_final, y_final};
     Z3_ast phi_2_final = Z3_mk_and(ctx, 2, phi_2_final_parts);  
@@ -138,7 +244,7 @@ Z3_ast create_phi_2(Z3_context ctx, const TunnelNetwork network, int length)
  * Pour chaque transmission, la hauteur reste identique
  */
 
-Z3_ast create_phi_3_trans(Z3_context ctx, const TunnelNetwork network, int length)
+Z3_ast create_phi_3_trans(Z3_context ctx, const TunnelNetwork network, int length, const tnVariables *variables)
 {
     int num_nodes = tn_get_num_nodes(network);
     int stack_size = get_stack_size(length);
@@ -168,25 +274,23 @@ Z3_ast create_phi_3_trans(Z3_context ctx, const TunnelNetwork network, int lengt
 
                     //x{node,pos,height} ∧ y{pos, height, protocol}
                     Z3_ast premise_parts[2];
-                    premise_parts[0] = tn_path_variable(ctx, node, pos, height);
+                    premise_parts[0] = tn_path_variable(variables, node, pos, height);
                     premise_parts[1] = (protocol == 4) ?
-                                        tn_4_variable(ctx, pos, height):
-                                        tn_6_variable(ctx, pos, height);
+                                        tn_4_variable(variables, pos, height):
+                                        tn_6_variable(variables, pos, height);
                     Z3_ast premise = Z3_mk_and(ctx, 2, premise_parts); 
                         
-                    // On cherche tous les voisins de node
-                    Z3_ast neighbors[num_nodes]; // Au max num_nodes voisins
+                    // On cherche tous les voisins de node (successeurs directs, sans parcourir tous les noeuds)
+                    const int *successors;
+                    size_t num_successors = tn_out_neighbours(network, node, &successors);
+                    Z3_ast neighbors[num_successors + 1];
                     int neighbor_count = 0;
                         
-                    for(int neighbor = 0; neighbor < num_nodes; neighbor++)
+                    for (size_t i = 0; i < num_successors; i++)
                     {
-                        // Vérifier s'il existe une arete uv
-                        if(tn_is_edge(network, node, neighbor))
-                        {
-                            // x{neighbor,pos+1,height}(même hauteur)
-                            neighbors[neighbor_count] = tn_path_variable(ctx, neighbor, pos + 1, height);
-                            neighbor_count++;  
-                        } 
+                        // x{neighbor,pos+1,height}(même hauteur)
+                        neighbors[neighbor_count] = tn_path_variable(variables, successors[i], pos + 1, height);
+                        neighbor_count++;  
                     } 
 
                     // Si aucun voisin, l'implication est vacuement vraie
@@ -216,7 +320,7 @@ Z3_ast create_phi_3_trans(Z3_context ctx, const TunnelNetwork network, int lengt
  * Pour chaque encapsulation, la hauteur augmente de 1.
  */
 
-Z3_ast create_phi_3_push(Z3_context ctx, const TunnelNetwork network, int length)
+Z3_ast create_phi_3_push(Z3_context ctx, const TunnelNetwork network, int length, const tnVariables *variables)
 {
     int num_nodes = tn_get_num_nodes(network);
     int stack_size = get_stack_size(length);
@@ -251,29 +355,28 @@ Z3_ast create_phi_3_push(Z3_context ctx, const TunnelNetwork network, int length
 
                         // Prémisse
                         Z3_ast premise_parts[2];
-                        premise_parts[0] = tn_path_variable(ctx, node, pos, height);
+                        premise_parts[0] = tn_path_variable(variables, node, pos, height);
                         premise_parts[1] = (protocol_a == 4)?
-                                            tn_4_variable(ctx, pos, height):
-                                            tn_6_variable(ctx, pos, height);
+                                            tn_4_variable(variables, pos, height):
+                                            tn_6_variable(variables, pos, height);
                         Z3_ast premise = Z3_mk_and(ctx, 2, premise_parts);
                     
                         // Conclusion
-                        Z3_ast neighbors[num_nodes];
+                        const int *successors;
+                        size_t num_successors = tn_out_neighbours(network, node, &successors);
+                        Z3_ast neighbors[num_successors + 1];
                         int neighbor_count = 0;
                     
-                        for (int neighbor = 0; neighbor < num_nodes; neighbor++)
+                        for (size_t i = 0; i < num_successors; i++)
                         {
-                            if(tn_is_edge(network, node, neighbor))
-                            {
-                                //x{neighbor, pos+1, height+1} ∧ y{pos+1, height+1, protocol_b}
-                                Z3_ast neighbor_parts[2];
-                                neighbor_parts[0] = tn_path_variable(ctx, neighbor, pos + 1, height + 1);
-                                neighbor_parts[1] = (protocol_b == 4)?
-                                                tn_4_variable(ctx, pos + 1, height + 1):
-                                                tn_6_variable(ctx, pos + 1, height + 1);
-                                neighbors[neighbor_count] = Z3_mk_and(ctx, 2, neighbor_parts);
-                                neighbor_count++;
-                            } 
+                            //x{neighbor, pos+1, height+1} ∧ y{pos+1, height+1, protocol_b}
+                            Z3_ast neighbor_parts[2];
+                            neighbor_parts[0] = tn_path_variable(variables, successors[i], pos + 1, height + 1);
+                            neighbor_parts[1] = (protocol_b == 4)?
+                                            tn_4_variable(variables, pos + 1, height + 1):
+                                            tn_6_variable(variables, pos + 1, height + 1);
+                            neighbors[neighbor_count] = Z3_mk_and(ctx, 2, neighbor_parts);
+                            neighbor_count++;
                         } 
                         if (neighbor_count == 0)
                         continue;
@@ -297,7 +400,7 @@ Z3_ast create_phi_3_push(Z3_context ctx, const TunnelNetwork network, int length
  * Pour chaque désencapsulation, la hauteur diminue de 1.
  */
 
-Z3_ast create_phi_3_pop(Z3_context ctx, const TunnelNetwork network, int length)
+Z3_ast create_phi_3_pop(Z3_context ctx, const TunnelNetwork network, int length, const tnVariables *variables)
 {
     int num_nodes = tn_get_num_nodes(network);
     int stack_size = get_stack_size(length);
@@ -332,26 +435,25 @@ Z3_ast create_phi_3_pop(Z3_context ctx, const TunnelNetwork network, int length)
 
                         // Prémisse
                         Z3_ast premise_parts[3];
-                        premise_parts[0] = tn_path_variable(ctx, node, pos, height);
+                        premise_parts[0] = tn_path_variable(variables, node, pos, height);
                         premise_parts[1] = (protocol_b == 4)?
-                                            tn_4_variable(ctx, pos, height):
-                                            tn_6_variable(ctx, pos, height);
+                                            tn_4_variable(variables, pos, height):
+                                            tn_6_variable(variables, pos, height);
                         premise_parts[2] = (protocol_a == 4)?
-                                            tn_4_variable(ctx, pos, height - 1):
-                                            tn_6_variable(ctx, pos, height - 1);
+                                            tn_4_variable(variables, pos, height - 1):
+                                            tn_6_variable(variables, pos, height - 1);
                         Z3_ast premise = Z3_mk_and(ctx, 3, premise_parts);
                     
                         // Conclusion
-                        Z3_ast neighbors[num_nodes];
+                        const int *successors;
+                        size_t num_successors = tn_out_neighbours(network, node, &successors);
+                        Z3_ast neighbors[num_successors + 1];
                         int neighbor_count = 0;
                     
-                        for (int neighbor = 0; neighbor < num_nodes; neighbor++)
+                        for (size_t i = 0; i < num_successors; i++)
                         {
-                            if(tn_is_edge(network, node, neighbor))
-                            {
-                                neighbors[neighbor_count] = tn_path_variable(ctx, neighbor, pos + 1, height -1);
-                                neighbor_count++;
-                            } 
+                            neighbors[neighbor_count] = tn_path_variable(variables, successors[i], pos + 1, height -1);
+                            neighbor_count++;
                         } 
                         if (neighbor_count == 0)
                         continue;
@@ -371,11 +473,11 @@ Z3_ast create_phi_3_pop(Z3_context ctx, const TunnelNetwork network, int length)
     return Z3_mk_and(ctx, impl_count, implications);    
 }
 
-Z3_ast create_phi_3(Z3_context ctx, const TunnelNetwork network, int length)
+Z3_ast create_phi_3(Z3_context ctx, const TunnelNetwork network, int length, const tnVariables *variables)
 {
-    Z3_ast phi_3_trans = create_phi_3_trans(ctx, network, length);
-    Z3_ast phi_3_push = create_phi_3_push(ctx, network, length);
-    Z3_ast phi_3_pop = create_phi_3_pop(ctx, network, length);
+    Z3_ast phi_3_trans = create_phi_3_trans(ctx, network, length, variables);
+    Z3_ast phi_3_push = create_phi_3_push(ctx, network, length, variables);
+    Z3_ast phi_3_pop = create_phi_3_pop(ctx, network, length, variables);
     Z3_ast phi_3_parts[3] ={phi_3_trans, phi_3_push, phi_3_pop};
     return Z3_mk_and(ctx, 3, phi_3_parts);  
 }
@@ -384,7 +486,7 @@ Z3_ast create_phi_3(Z3_context ctx, const TunnelNetwork network, int length)
  * Créer la formule φ4 exprimant chaque cellule contient 4 ou 6 (exclusif)
  */
 
-Z3_ast create_phi_4(Z3_context ctx, const TunnelNetwork network, int length)
+Z3_ast create_phi_4(Z3_context ctx, const TunnelNetwork network, int length, const tnVariables *variables)
 {
     int num_nodes = tn_get_num_nodes(network);
     int stack_size = get_stack_size(length);
@@ -403,7 +505,7 @@ Z3_ast create_phi_4(Z3_context ctx, const TunnelNetwork network, int length)
             Z3_ast premise_nodes[num_nodes];
             for (int node =0; node < num_nodes; node++)
             {
-                premise_nodes[node] = tn_path_variable(ctx, node, pos, height);
+                premise_nodes[node] = tn_path_variable(variables, node, pos, height);
             }  
             Z3_ast premise = Z3_mk_or(ctx, num_nodes, premise_nodes);
 
@@ -412,8 +514,8 @@ Z3_ast create_phi_4(Z3_context ctx, const TunnelNetwork network, int length)
             for(int cell = 0; cell <= height; cell++)
             {
                 // var pour cette cell
-                Z3_ast y_4 = tn_4_variable(ctx, pos, cell);
-                Z3_ast y_6 = tn_6_variable(ctx, pos, cell);
+                Z3_ast y_4 = tn_4_variable(variables, pos, cell);
+                Z3_ast y_6 = tn_6_variable(variables, pos, cell);
 
                 // y{pos,cell,4} ∧ ¬y{pos,cell,6}  (contient 4 exclusif)
                 Z3_ast contains_4_parts[2];
@@ -446,7 +548,7 @@ Z3_ast create_phi_4(Z3_context ctx, const TunnelNetwork network, int length)
 /**
  * φ5 : Le sommet de pile doit être compatible avec AU MOINS UNE action du nœud
  */
-Z3_ast create_phi_5(Z3_context ctx, const TunnelNetwork network, int length)
+Z3_ast create_phi_5(Z3_context ctx, const TunnelNetwork network, int length, const tnVariables *variables)
 {
     int num_nodes = tn_get_num_nodes(network);
     int stack_size = get_stack_size(length);
@@ -465,7 +567,7 @@ Z3_ast create_phi_5(Z3_context ctx, const TunnelNetwork network, int length)
             for (int height = 0; height < stack_size; height++)
             {
                 // Prémisse : x_{node, pos, height}
-                Z3_ast premise = tn_path_variable(ctx, node, pos, height);
+                Z3_ast premise = tn_path_variable(variables, node, pos, height);
                 
                 // Conclusion : disjonction des conditions de sommet de pile
                 // pour chaque action que le nœud peut faire
@@ -476,12 +578,12 @@ Z3_ast create_phi_5(Z3_context ctx, const TunnelNetwork network, int length)
                 // Transmissions : T4 requiert sommet = 4, T6 requiert sommet = 6
                 if (tn_node_has_action(network, node, transmit_4))
                 {
-                    conditions[cond_count] = tn_4_variable(ctx, pos, height);
+                    conditions[cond_count] = tn_4_variable(variables, pos, height);
                     cond_count++;
                 }
                 if (tn_node_has_action(network, node, transmit_6))
                 {
-                    conditions[cond_count] = tn_6_variable(ctx, pos, height);
+                    conditions[cond_count] = tn_6_variable(variables, pos, height);
                     cond_count++;
                 }
                 
@@ -489,13 +591,13 @@ Z3_ast create_phi_5(Z3_context ctx, const TunnelNetwork network, int length)
                 if (tn_node_has_action(network, node, push_4_4) || 
                     tn_node_has_action(network, node, push_4_6))
                 {
-                    conditions[cond_count] = tn_4_variable(ctx, pos, height);
+                    conditions[cond_count] = tn_4_variable(variables, pos, height);
                     cond_count++;
                 }
                 if (tn_node_has_action(network, node, push_6_4) || 
                     tn_node_has_action(network, node, push_6_6))
                 {
-                    conditions[cond_count] = tn_6_variable(ctx, pos, height);
+                    conditions[cond_count] = tn_6_variable(variables, pos, height);
                     cond_count++;
                 }
                 
@@ -506,32 +608,32 @@ Z3_ast create_phi_5(Z3_context ctx, const TunnelNetwork network, int length)
                     if (tn_node_has_action(network, node, pop_4_4))
                     {
                         // sommet = 4 et dessous = 4
-                        Z3_ast parts[2] = {tn_4_variable(ctx, pos, height), 
-                                           tn_4_variable(ctx, pos, height - 1)};
+                        Z3_ast parts[2] = {tn_4_variable(variables, pos, height), 
+                                           tn_4_variable(variables, pos, height - 1)};
                         conditions[cond_count] = Z3_mk_and(ctx, 2, parts);
                         cond_count++;
                     }
                     if (tn_node_has_action(network, node, pop_4_6))
                     {
                         // sommet = 6 et dessous = 4
-                        Z3_ast parts[2] = {tn_6_variable(ctx, pos, height), 
-                                           tn_4_variable(ctx, pos, height - 1)};
+                        Z3_ast parts[2] = {tn_6_variable(variables, pos, height), 
+                                           tn_4_variable(variables, pos, height - 1)};
                         conditions[cond_count] = Z3_mk_and(ctx, 2, parts);
                         cond_count++;
                     }
                     if (tn_node_has_action(network, node, pop_6_4))
                     {
                         // sommet = 4 et dessous = 6
-                        Z3_ast parts[2] = {tn_4_variable(ctx, pos, height), 
-                                           tn_6_variable(ctx, pos, height - 1)};
+                        Z3_ast parts[2] = {tn_4_variable(variables, pos, height), 
+                                           tn_6_variable(variables, pos, height - 1)};
                         conditions[cond_count] = Z3_mk_and(ctx, 2, parts);
                         cond_count++;
                     }
                     if (tn_node_has_action(network, node, pop_6_6))
                     {
                         // sommet = 6 et dessous = 6
-                        Z3_ast parts[2] = {tn_6_variable(ctx, pos, height), 
-                                           tn_6_variable(ctx, pos, height - 1)};
+                        Z3_ast parts[2] = {tn_6_variable(variables, pos, height), 
+                                           tn_6_variable(variables, pos, height - 1)};
                         conditions[cond_count] = Z3_mk_and(ctx, 2, parts);
                         cond_count++;
                     }
@@ -566,7 +668,7 @@ Z3_ast create_phi_5(Z3_context ctx, const TunnelNetwork network, int length)
  * Pour chaque désencapsulation, les cellules de  à height - restent idéntiques
  */
 
-Z3_ast create_phi_6_trans(Z3_context ctx, const TunnelNetwork network, int length)
+Z3_ast create_phi_6_trans(Z3_context ctx, const TunnelNetwork network, int length, const tnVariables *variables)
 {
     int num_nodes = tn_get_num_nodes(network);
     int stack_size = get_stack_size(length);
@@ -593,7 +695,7 @@ Z3_ast create_phi_6_trans(Z3_context ctx, const TunnelNetwork network, int lengt
                         continue;
                     
                     // Prémisse
-                    Z3_ast premise = tn_path_variable(ctx,node, pos, height) ;
+                    Z3_ast premise = tn_path_variable(variables, node, pos, height) ;
                     
                     // Conclusion 
                     // Pour chaque cellule k de  à height, la cellule reste identique
@@ -602,13 +704,13 @@ Z3_ast create_phi_6_trans(Z3_context ctx, const TunnelNetwork network, int lengt
                    {
                     //y{pos,cell,4}<=>y{pos+1,cell,4}  
                     Z3_ast eq_4 = Z3_mk_eq(ctx, 
-                                        tn_4_variable(ctx, pos, cell),
-                                        tn_4_variable(ctx, pos + 1, cell));
+                                        tn_4_variable(variables, pos, cell),
+                                        tn_4_variable(variables, pos + 1, cell));
                      
                     //y{pos,cell,6}<=>y{pos+1,cell,6}
                     Z3_ast eq_6 = Z3_mk_eq(ctx, 
-                                        tn_6_variable(ctx, pos, cell),
-                                        tn_6_variable(ctx, pos + 1, cell));
+                                        tn_6_variable(variables, pos, cell),
+                                        tn_6_variable(variables, pos + 1, cell));
 
                     // Conjonction
                     Z3_ast preservation_parts[2] ={eq_4, eq_6};
@@ -627,7 +729,7 @@ Z3_ast create_phi_6_trans(Z3_context ctx, const TunnelNetwork network, int lengt
    return Z3_mk_and(ctx, impl_count, implications);     
 }
 
-Z3_ast create_phi_6_push(Z3_context ctx, const TunnelNetwork network, int length)
+Z3_ast create_phi_6_push(Z3_context ctx, const TunnelNetwork network, int length, const tnVariables *variables)
 {
     int num_nodes = tn_get_num_nodes(network);
     int stack_size = get_stack_size(length);
@@ -661,7 +763,7 @@ Z3_ast create_phi_6_push(Z3_context ctx, const TunnelNetwork network, int length
                             continue;
 
                         // Prémisse
-                        Z3_ast premise = tn_path_variable(ctx,node, pos, height);
+                        Z3_ast premise = tn_path_variable(variables, node, pos, height);
         
                         // Conclusion
                         Z3_ast cell_preservations[height + 1];
@@ -669,13 +771,13 @@ Z3_ast create_phi_6_push(Z3_context ctx, const TunnelNetwork network, int length
                         {
                         //y{pos,cell,4}<=>y{pos+1,cell,4}  
                         Z3_ast eq_4 = Z3_mk_eq(ctx, 
-                                            tn_4_variable(ctx, pos, cell),
-                                            tn_4_variable(ctx, pos + 1, cell));
+                                            tn_4_variable(variables, pos, cell),
+                                            tn_4_variable(variables, pos + 1, cell));
                             
                         //y{pos,cell,6}<=>y{pos+1,cell,6}
                         Z3_ast eq_6 = Z3_mk_eq(ctx, 
-                                            tn_6_variable(ctx, pos, cell),
-                                            tn_6_variable(ctx, pos + 1, cell));
+                                            tn_6_variable(variables, pos, cell),
+                                            tn_6_variable(variables, pos + 1, cell));
 
                         // Conjonction
                         Z3_ast preservation_parts[2] ={eq_4, eq_6};
@@ -697,7 +799,7 @@ Z3_ast create_phi_6_push(Z3_context ctx, const TunnelNetwork network, int length
     return Z3_mk_and(ctx, impl_count, implications);       
 }
 
-Z3_ast create_phi_6_pop(Z3_context ctx, const TunnelNetwork network, int length)
+Z3_ast create_phi_6_pop(Z3_context ctx, const TunnelNetwork network, int length, const tnVariables *variables)
 {
     int num_nodes = tn_get_num_nodes(network);
     int stack_size = get_stack_size(length);
@@ -731,7 +833,7 @@ Z3_ast create_phi_6_pop(Z3_context ctx, const TunnelNetwork network, int length)
                             continue;
 
                         // Prémisse
-                        Z3_ast premise = tn_path_variable(ctx,node, pos, height);
+                        Z3_ast premise = tn_path_variable(variables, node, pos, height);
         
                         // Conclusion
                         // les cellules de 0 à height - 1 restent identiques et on retire la cellule height
@@ -739,12 +841,12 @@ Z3_ast create_phi_6_pop(Z3_context ctx, const TunnelNetwork network, int length)
                         {
                             //si height = 1, on verifie juste la cellule 0 
                             Z3_ast eq_4 = Z3_mk_eq(ctx, 
-                                                tn_4_variable(ctx, pos, 0),
-                                                tn_4_variable(ctx, pos + 1, 0));
+                                                tn_4_variable(variables, pos, 0),
+                                                tn_4_variable(variables, pos + 1, 0));
 
                             Z3_ast eq_6 = Z3_mk_eq(ctx, 
-                                                tn_6_variable(ctx, pos, 0),
-                                                tn_6_variable(ctx, pos + 1, 0));
+                                                tn_6_variable(variables, pos, 0),
+                                                tn_6_variable(variables, pos + 1, 0));
 
                             // Conjonction
                             Z3_ast preservation_parts[2] ={eq_4, eq_6};
@@ -758,12 +860,12 @@ Z3_ast create_phi_6_pop(Z3_context ctx, const TunnelNetwork network, int length)
                             for (int cell = 0; cell < height; cell++)
                             {
                                 Z3_ast eq_4 = Z3_mk_eq(ctx, 
-                                                    tn_4_variable(ctx, pos, cell),
-                                                    tn_4_variable(ctx, pos + 1, cell));
+                                                    tn_4_variable(variables, pos, cell),
+                                                    tn_4_variable(variables, pos + 1, cell));
 
                                 Z3_ast eq_6 = Z3_mk_eq(ctx, 
-                                                    tn_6_variable(ctx, pos, cell),
-                                                    tn_6_variable(ctx, pos + 1, cell));
+                                                    tn_6_variable(variables, pos, cell),
+                                                    tn_6_variable(variables, pos + 1, cell));
 
                                 // Conjonction
                                 Z3_ast preservation_parts[2] ={eq_4, eq_6};
@@ -783,11 +885,11 @@ Z3_ast create_phi_6_pop(Z3_context ctx, const TunnelNetwork network, int length)
     return Z3_mk_and(ctx, impl_count, implications);       
 }
 
-Z3_ast create_phi_6(Z3_context ctx, const TunnelNetwork network, int length)
+Z3_ast create_phi_6(Z3_context ctx, const TunnelNetwork network, int length, const tnVariables *variables)
 {
-    Z3_ast phi_6_trans = create_phi_6_trans(ctx, network, length);
-    Z3_ast phi_6_push = create_phi_6_push(ctx, network, length);
-    Z3_ast phi_6_pop = create_phi_6_pop(ctx, network, length);
+    Z3_ast phi_6_trans = create_phi_6_trans(ctx, network, length, variables);
+    Z3_ast phi_6_push = create_phi_6_push(ctx, network, length, variables);
+    Z3_ast phi_6_pop = create_phi_6_pop(ctx, network, length, variables);
 
     Z3_ast phi_6_parts[3] ={phi_6_trans, phi_6_push, phi_6_pop};
     return Z3_mk_and(ctx, 3, phi_6_parts);  
@@ -796,7 +898,7 @@ Z3_ast create_phi_6(Z3_context ctx, const TunnelNetwork network, int length)
 /**
  * Chemin simple (pas de répétition de sommets)
  */
-Z3_ast create_phi_7(Z3_context ctx, const TunnelNetwork network, int length)
+Z3_ast create_phi_7(Z3_context ctx, const TunnelNetwork network, int length, const tnVariables *variables)
 {
     int num_nodes = tn_get_num_nodes(network);
     int stack_size = get_stack_size(length);
@@ -819,8 +921,8 @@ Z3_ast create_phi_7(Z3_context ctx, const TunnelNetwork network, int length)
                 
                 for (int h = 0; h < stack_size; h++)
                {
-                    at_pos1[h] = tn_path_variable(ctx, node, pos1, h);
-                    at_pos2[h] = tn_path_variable(ctx, node, pos2, h);  
+                    at_pos1[h] = tn_path_variable(variables, node, pos1, h);
+                    at_pos2[h] = tn_path_variable(variables, node, pos2, h);  
                } 
 
                Z3_ast node_at_pos1 = Z3_mk_or(ctx, stack_size, at_pos1);
@@ -837,25 +939,33 @@ Z3_ast create_phi_7(Z3_context ctx, const TunnelNetwork network, int length)
     return Z3_mk_and(ctx, clause_count, clauses);
 }
 
-Z3_ast tn_reduction(Z3_context ctx, const TunnelNetwork network, int length)
+Z3_ast tn_reduction(Z3_context ctx, VariableTable table, const TunnelNetwork network, int length)
 {
-    Z3_ast phi_1 = create_phi_1(ctx, network, length);
-    Z3_ast phi_2 = create_phi_2(ctx, network, length);
-    Z3_ast phi_3 = create_phi_3(ctx, network, length);
-    Z3_ast phi_4 = create_phi_4(ctx, network, length);
-    Z3_ast phi_5 = create_phi_5(ctx, network, length);
-    Z3_ast phi_6 = create_phi_6(ctx, network, length);
-    Z3_ast phi_7 = create_phi_7(ctx, network, length);
+    tnVariables variables = tn_variables(table);
+    Z3_ast phi_1 = create_phi_1(ctx, network, length, &variables);
+    Z3_ast phi_2 = create_phi_2(ctx, network, length, &variables);
+    Z3_ast phi_3 = create_phi_3(ctx, network, length, &variables);
+    Z3_ast phi_4 = create_phi_4(ctx, network, length, &variables);
+    Z3_ast phi_5 = create_phi_5(ctx, network, length, &variables);
+    Z3_ast phi_6 = create_phi_6(ctx, network, length, &variables);
+    Z3_ast phi_7 = create_phi_7(ctx, network, length, &variables);
 
     // Combiner φ1 , φ2 , φ3 , φ4 , φ5 , φ6 et φ7
     Z3_ast formulas[7] = {phi_1, phi_2, phi_3, phi_4, phi_5, phi_6, phi_7};
     return Z3_mk_and(ctx, 7, formulas);
 }
 
-void tn_get_path_from_model(Z3_context ctx, Z3_model model, TunnelNetwork network, int bound, tn_step *path)
+Z3_ast tn_readable_formula(Z3_context ctx, VariableTable table, Z3_ast formula)
+{
+    return variable_table_readable(table, formula);
+}
+
+void tn_get_path_from_model(Z3_context ctx, VariableTable table, Z3_model model, TunnelNetwork network, int bound, tn_step *path)
 {
     int num_nodes = tn_get_num_nodes(network);
     int stack_size = get_stack_size(bound);
+    tnVariables variables = tn_variables(table);
+    uint64_t *values = variable_table_model_values(variables.table, model);
     for (int pos = 0; pos < bound; pos++)
     {
         int src = -1;
@@ -866,12 +976,12 @@ void tn_get_path_from_model(Z3_context ctx, Z3_model model, TunnelNetwork networ
         {
             for (int height = 0; height < stack_size; height++)
             {
-                if (value_of_var_in_model(ctx, model, tn_path_variable(ctx, n, pos, height)))
+                if (tn_path_value(&variables, values, n, pos, height))
                 {
                     src = n;
                     src_height = height;
                 }
-                if (value_of_var_in_model(ctx, model, tn_path_variable(ctx, n, pos + 1, height)))
+                if (tn_path_value(&variables, values, n, pos + 1, height))
                 {
                     tgt = n;
                     tgt_height = height;
@@ -881,21 +991,21 @@ void tn_get_path_from_model(Z3_context ctx, Z3_model model, TunnelNetwork networ
         int action = 0;
         if (src_height == tgt_height)
         {
-            if (value_of_var_in_model(ctx, model, tn_4_variable(ctx, pos, src_height)))
+            if (tn_4_value(&variables, values, pos, src_height))
                 action = transmit_4;
             else
                 action = transmit_6;
         }
         else if (src_height == tgt_height - 1)
         {
-            if (value_of_var_in_model(ctx, model, tn_4_variable(ctx, pos, src_height)))
+            if (tn_4_value(&variables, values, pos, src_height))
             {
-                if (value_of_var_in_model(ctx, model, tn_4_variable(ctx, pos + 1, tgt_height)))
+                if (tn_4_value(&variables, values, pos + 1, tgt_height))
                     action = push_4_4;
                 else
                     action = push_4_6;
             }
-            else if (value_of_var_in_model(ctx, model, tn_4_variable(ctx, pos + 1, tgt_height)))
+            else if (tn_4_value(&variables, values, pos + 1, tgt_height))
                 action = push_6_4;
             else
                 action = push_6_6;
@@ -903,14 +1013,14 @@ void tn_get_path_from_model(Z3_context ctx, Z3_model model, TunnelNetwork networ
         else if (src_height == tgt_height + 1)
         {
             {
-                if (value_of_var_in_model(ctx, model, tn_4_variable(ctx, pos, src_height)))
+                if (tn_4_value(&variables, values, pos, src_height))
                 {
-                    if (value_of_var_in_model(ctx, model, tn_4_variable(ctx, pos + 1, tgt_height)))
+                    if (tn_4_value(&variables, values, pos + 1, tgt_height))
                         action = pop_4_4;
                     else
                         action = pop_6_4;
                 }
-                else if (value_of_var_in_model(ctx, model, tn_4_variable(ctx, pos + 1, tgt_height)))
+                else if (tn_4_value(&variables, values, pos + 1, tgt_height))
                     action = pop_4_6;
                 else
                     action = pop_6_6;
@@ -918,12 +1028,15 @@ void tn_get_path_from_model(Z3_context ctx, Z3_model model, TunnelNetwork networ
         }
         path[pos] = tn_step_create(action, src, tgt);
     }
+    free(values);
 }
 
-void tn_print_model(Z3_context ctx, Z3_model model, TunnelNetwork network, int bound)
+void tn_print_model(Z3_context ctx, VariableTable table, Z3_model model, TunnelNetwork network, int bound)
 {
     int num_nodes = tn_get_num_nodes(network);
     int stack_size = get_stack_size(bound);
+    tnVariables variables = tn_variables(table);
+    uint64_t *values = variable_table_model_values(variables.table, model);
     for (int pos = 0; pos < bound + 1; pos++)
     {
         printf("At pos %d:\nState: ", pos);
@@ -932,7 +1045,7 @@ void tn_print_model(Z3_context ctx, Z3_model model, TunnelNetwork network, int b
         {
             for (int height = 0; height < stack_size; height++)
             {
-                if (value_of_var_in_model(ctx, model, tn_path_variable(ctx, node, pos, height)))
+                if (tn_path_value(&variables, values, node, pos, height))
                 {
                     printf("(%s,%d) ", tn_get_node_name(network, node), height);
                     num_seen++;
@@ -950,9 +1063,9 @@ void tn_print_model(Z3_context ctx, Z3_model model, TunnelNetwork network, int b
         bool above_top = false;
         for (int height = 0; height < stack_size; height++)
         {
-            if (value_of_var_in_model(ctx, model, tn_4_variable(ctx, pos, height)))
+            if (tn_4_value(&variables, values, pos, height))
             {
-                if (value_of_var_in_model(ctx, model, tn_6_variable(ctx, pos, height)))
+                if (tn_6_value(&variables, values, pos, height))
                 {
                     printf("|X");
                     misdefined = true;
@@ -964,7 +1077,7 @@ void tn_print_model(Z3_context ctx, Z3_model model, TunnelNetwork network, int b
                         misdefined = true;
                 }
             }
-            else if (value_of_var_in_model(ctx, model, tn_6_variable(ctx, pos, height)))
+            else if (tn_6_value(&variables, values, pos, height))
             {
                 printf("|6");
                 if (above_top)
@@ -980,5 +1093,5 @@ void tn_print_model(Z3_context ctx, Z3_model model, TunnelNetwork network, int b
         if (misdefined)
             printf("Warning: ill-defined stack\n");
     }
-    return;
+    free(values);
 }
\ No newline at end of file
@@ -0,0 +1,172 @@
+/**
+ * @file Arena.c
+ * @brief Region (bump) allocator over a list of blocks.
+ * @version 1
+ * @date 2026-10-15
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#include "Arena.h"
+#include <stdalign.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Size of the first block of an arena. Each new block is twice as large as the previous one, up to ARENA_MAX_BLOCK.
+ *
+ */
+#define ARENA_FIRST_BLOCK 4096
+
+/**
+ * @brief Largest size of the blocks filled by successive allocations. Larger allocations get a block of their own.
+ *
+ */
+#define ARENA_MAX_BLOCK (8 * 1024 * 1024)
+
+/**
+ * @brief Alignment of every allocation.
+ *
+ */
+#define ARENA_ALIGNMENT alignof(max_align_t)
+
+/**
+ * @brief Block of an arena.
+ *
+ */
+typedef struct arenaBlock
+{
+	struct arenaBlock *next;		   ///< The previously filled block.
+	size_t used;					   ///< The number of bytes used in data.
+	size_t capacity;				   ///< The size of data.
+	alignas(max_align_t) char data[]; ///< The memory.
+} arenaBlock;
+
+/**
+ * @brief Function to call when an arena is freed.
+ *
+ */
+typedef struct arenaCleanup
+{
+	struct arenaCleanup *next; ///< The previously registered function.
+	void (*cleanup)(void *);   ///< The function.
+	void *data;				   ///< Its argument.
+} arenaCleanup;
+
+struct arena_s
+{
+	arenaBlock *block;	 ///< The block currently filled (NULL if nothing was allocated).
+	size_t next_capacity; ///< The size of the next block (at most ARENA_MAX_BLOCK).
+	size_t used;		 ///< The number of bytes allocated.
+	int references;		 ///< The number of references to the arena.
+	arenaCleanup *cleanups; ///< The functions to call when the arena is freed (allocated in the arena).
+};
+
+Arena arena_create(void)
+{
+	Arena arena = (Arena)malloc(sizeof(*arena));
+	arena->block = NULL;
+	arena->next_capacity = ARENA_FIRST_BLOCK;
+	arena->used = 0;
+	arena->references = 1;
+	arena->cleanups = NULL;
+	return arena;
+}
+
+Arena arena_retain(Arena arena)
+{
+	arena->references++;
+	return arena;
+}
+
+void arena_release(Arena arena)
+{
+	if (--arena->references > 0)
+		return;
+	for (arenaCleanup *cleanup = arena->cleanups; cleanup != NULL; cleanup = cleanup->next)
+		cleanup->cleanup(cleanup->data);
+	arenaBlock *block = arena->block;
+	while (block != NULL)
+	{
+		arenaBlock *next = block->next;
+		free(block);
+		block = next;
+	}
+	free(arena);
+}
+
+void arena_add_cleanup(Arena arena, void (*cleanup)(void *), void *data)
+{
+	arenaCleanup *cell = (arenaCleanup *)arena_alloc(arena, sizeof(arenaCleanup));
+	cell->cleanup = cleanup;
+	cell->data = data;
+	cell->next = arena->cleanups;
+	arena->cleanups = cell;
+}
+
+bool arena_is_shared(Arena arena)
+{
+	return arena->references > 1;
+}
+
+void *arena_alloc(Arena arena, size_t size)
+{
+	size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+	if (size == 0)
+		size = ARENA_ALIGNMENT;
+	arenaBlock *block = arena->block;
+	if (size > arena->next_capacity)
+	{
+		// A large allocation (such as a matrix of edges) gets a block of its own, kept behind the block being filled, and does not make the next blocks larger.
+		arenaBlock *own = (arenaBlock *)malloc(sizeof(arenaBlock) + size);
+		own->used = size;
+		own->capacity = size;
+		if (block == NULL)
+		{
+			own->next = NULL;
+			arena->block = own;
+		}
+		else
+		{
+			own->next = block->next;
+			block->next = own;
+		}
+		arena->used += size;
+		return own->data;
+	}
+	if (block == NULL || block->capacity - block->used < size)
+	{
+		size_t capacity = arena->next_capacity;
+		if (arena->next_capacity < ARENA_MAX_BLOCK)
+			arena->next_capacity = 2 * capacity;
+		block = (arenaBlock *)malloc(sizeof(arenaBlock) + capacity);
+		block->used = 0;
+		block->capacity = capacity;
+		block->next = arena->block;
+		arena->block = block;
+	}
+	void *result = block->data + block->used;
+	block->used += size;
+	arena->used += size;
+	return result;
+}
+
+char *arena_strdup(Arena arena, const char *string)
+{
+	size_t length = strlen(string) + 1;
+	return (char *)memcpy(arena_alloc(arena, length), string, length);
+}
+
+char *arena_strndup(Arena arena, const char *string, size_t length)
+{
+	char *copy = (char *)arena_alloc(arena, length + 1);
+	memcpy(copy, string, length);
+	copy[length] = '\0';
+	return copy;
+}
+
+size_t arena_used(Arena arena)
+{
+	return arena->used;
+}
@@ -0,0 +1,279 @@
+/**
+ * @file Atoms.c
+ * @brief Global table of interned strings (open-addressed hash table over a pool of characters, with lock-free lookups).
+ * @version 1
+ * @date 2026-10-15
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#include "Atoms.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Default size of a block of the character pool.
+ *
+ */
+#define ATOM_POOL_BLOCK 65536
+
+/**
+ * @brief log2 of the number of entries of the first chunk of the directory. Chunk k holds 2^(ATOM_FIRST_CHUNK_BITS + k) entries.
+ *
+ */
+#define ATOM_FIRST_CHUNK_BITS 8
+
+/**
+ * @brief The number of chunks of the directory: enough for every non-negative atom.
+ *
+ */
+#define ATOM_MAX_CHUNKS (32 - ATOM_FIRST_CHUNK_BITS)
+
+/**
+ * @brief Block of the pool storing the characters of interned strings. Blocks are never freed nor moved, so interned strings are stable.
+ *
+ */
+typedef struct atomPoolBlock
+{
+	struct atomPoolBlock *next; ///< The previously filled block.
+	size_t used;				///< The number of characters used in data.
+	size_t capacity;			///< The size of data.
+	char data[];				///< The characters.
+} atomPoolBlock;
+
+/**
+ * @brief What the table knows of an atom.
+ *
+ */
+typedef struct
+{
+	char *string;  ///< Its string, in the pool.
+	int length;	   ///< The length of the string.
+	uint32_t hash; ///< The hash of the string.
+} atomEntry;
+
+/**
+ * @brief Open-addressed index from hashes to atoms. An index is replaced by a larger one when it fills up, but never freed, so that a thread may still read it.
+ *
+ */
+typedef struct atomIndex
+{
+	struct atomIndex *previous; ///< The index it replaced.
+	size_t num_slots;			///< The number of slots (a power of 2).
+	_Atomic(atom) slots[];		///< The atom of each slot (NO_ATOM if free).
+} atomIndex;
+
+/**
+ * @brief The table of interned strings. The entries are stored in a directory of chunks of doubling sizes, which are never moved: an atom and its entry, once
+ *        published in the index, can be read without locking while other threads intern strings.
+ *
+ */
+static struct
+{
+	_Atomic(atomEntry *) chunks[ATOM_MAX_CHUNKS]; ///< The chunks of entries (NULL if not allocated yet).
+	_Atomic(int) count;							  ///< The number of atoms.
+	_Atomic(atomIndex *) index;					  ///< The current index (NULL before the first atom).
+	atomPoolBlock *pool;						  ///< The block currently filled.
+} table;
+
+/**
+ * @brief Serializes the insertions in the table. Lookups and reads do not take it.
+ *
+ */
+static pthread_mutex_t table_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief FNV-1a hash of a sequence of characters.
+ *
+ * @param string The characters.
+ * @param length Their number.
+ * @return uint32_t The hash.
+ */
+static uint32_t atom_hash(const char *string, int length)
+{
+	uint32_t hash = 2166136261u;
+	for (int i = 0; i < length; i++)
+	{
+		hash ^= (unsigned char)string[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * @brief Returns the entry of an atom.
+ *
+ * @param id An atom.
+ * @return atomEntry* Its entry.
+ */
+static atomEntry *atom_entry(atom id)
+{
+	unsigned position = (unsigned)id + (1u << ATOM_FIRST_CHUNK_BITS);
+	int chunk = 31 - __builtin_clz(position) - ATOM_FIRST_CHUNK_BITS;
+	atomEntry *entries = atomic_load_explicit(&table.chunks[chunk], memory_order_acquire);
+	return entries + (position - (1u << (ATOM_FIRST_CHUNK_BITS + chunk)));
+}
+
+/**
+ * @brief Finds the slot of the sequence given in argument, or the free slot where it should be inserted.
+ *
+ * @param index The index searched.
+ * @param string The characters.
+ * @param length Their number.
+ * @param hash Their hash.
+ * @return size_t The index of the slot.
+ */
+static size_t atom_find_slot(atomIndex *index, const char *string, int length, uint32_t hash)
+{
+	size_t slot = hash & (index->num_slots - 1);
+	atom id;
+	while ((id = atomic_load_explicit(&index->slots[slot], memory_order_acquire)) != NO_ATOM)
+	{
+		atomEntry *entry = atom_entry(id);
+		if (entry->hash == hash && entry->length == length && memcmp(entry->string, string, length) == 0)
+			return slot;
+		slot = (slot + 1) & (index->num_slots - 1);
+	}
+	return slot;
+}
+
+/**
+ * @brief Looks a sequence of characters up, without locking.
+ *
+ * @param string The characters.
+ * @param length Their number.
+ * @param hash Their hash.
+ * @return atom Its atom, or NO_ATOM.
+ */
+static atom atom_find(const char *string, int length, uint32_t hash)
+{
+	atomIndex *index = atomic_load_explicit(&table.index, memory_order_acquire);
+	return index == NULL ? NO_ATOM : atomic_load_explicit(&index->slots[atom_find_slot(index, string, length, hash)], memory_order_acquire);
+}
+
+/**
+ * @brief Replaces the index by one with twice its slots (or creates it). Called with table_mutex held.
+ *
+ * @param count The number of atoms.
+ */
+static void atom_grow_index(int count)
+{
+	atomIndex *current = atomic_load_explicit(&table.index, memory_order_relaxed);
+	size_t num_slots = current == NULL ? 1024 : 2 * current->num_slots;
+	atomIndex *index = (atomIndex *)malloc(sizeof(atomIndex) + num_slots * sizeof(atom));
+	index->previous = current;
+	index->num_slots = num_slots;
+	for (size_t i = 0; i < num_slots; i++)
+		atomic_init(&index->slots[i], NO_ATOM);
+	for (atom id = 0; id < count; id++)
+	{
+		size_t slot = atom_entry(id)->hash & (num_slots - 1);
+		while (atomic_load_explicit(&index->slots[slot], memory_order_relaxed) != NO_ATOM)
+			slot = (slot + 1) & (num_slots - 1);
+		atomic_init(&index->slots[slot], id);
+	}
+	atomic_store_explicit(&table.index, index, memory_order_release);
+}
+
+/**
+ * @brief Copies a sequence of characters (and a final null character) in the pool. Called with table_mutex held.
+ *
+ * @param string The characters.
+ * @param length Their number.
+ * @return char* The stable copy.
+ */
+static char *atom_pool_store(const char *string, int length)
+{
+	size_t needed = (size_t)length + 1;
+	if (table.pool == NULL || table.pool->capacity - table.pool->used < needed)
+	{
+		size_t capacity = needed > ATOM_POOL_BLOCK ? needed : ATOM_POOL_BLOCK;
+		atomPoolBlock *block = (atomPoolBlock *)malloc(sizeof(atomPoolBlock) + capacity);
+		block->next = table.pool;
+		block->used = 0;
+		block->capacity = capacity;
+		table.pool = block;
+	}
+	char *copy = table.pool->data + table.pool->used;
+	memcpy(copy, string, length);
+	copy[length] = '\0';
+	table.pool->used += needed;
+	return copy;
+}
+
+atom atom_intern_length(const char *string, int length)
+{
+	uint32_t hash = atom_hash(string, length);
+	// Most strings are already interned: they are found without locking.
+	atom id = atom_find(string, length, hash);
+	if (id != NO_ATOM)
+		return id;
+
+	pthread_mutex_lock(&table_mutex);
+	int count = atomic_load_explicit(&table.count, memory_order_relaxed);
+	atomIndex *index = atomic_load_explicit(&table.index, memory_order_relaxed);
+	if (index == NULL || 2 * ((size_t)count + 1) > index->num_slots)
+	{
+		atom_grow_index(count);
+		index = atomic_load_explicit(&table.index, memory_order_relaxed);
+	}
+	// Another thread may have interned the string since it was looked up.
+	size_t slot = atom_find_slot(index, string, length, hash);
+	id = atomic_load_explicit(&index->slots[slot], memory_order_relaxed);
+	if (id == NO_ATOM)
+	{
+		id = count;
+		unsigned position = (unsigned)id + (1u << ATOM_FIRST_CHUNK_BITS);
+		int chunk = 31 - __builtin_clz(position) - ATOM_FIRST_CHUNK_BITS;
+		if (atomic_load_explicit(&table.chunks[chunk], memory_order_relaxed) == NULL)
+			atomic_store_explicit(&table.chunks[chunk], (atomEntry *)malloc(sizeof(atomEntry) << (ATOM_FIRST_CHUNK_BITS + chunk)), memory_order_release);
+		atomEntry *entry = atom_entry(id);
+		entry->string = atom_pool_store(string, length);
+		entry->length = length;
+		entry->hash = hash;
+		atomic_store_explicit(&table.count, count + 1, memory_order_release);
+		// Publishing the atom in the index makes its entry visible to the lookups of the other threads.
+		atomic_store_explicit(&index->slots[slot], id, memory_order_release);
+	}
+	pthread_mutex_unlock(&table_mutex);
+	return id;
+}
+
+atom atom_intern(const char *string)
+{
+	return atom_intern_length(string, strlen(string));
+}
+
+atom atom_lookup(const char *string)
+{
+	int length = strlen(string);
+	return atom_find(string, length, atom_hash(string, length));
+}
+
+char *atom_string(atom id)
+{
+	return atom_entry(id)->string;
+}
+
+size_t atom_memory_usage(void)
+{
+	pthread_mutex_lock(&table_mutex);
+	size_t bytes = 0;
+	for (int chunk = 0; chunk < ATOM_MAX_CHUNKS && atomic_load_explicit(&table.chunks[chunk], memory_order_relaxed) != NULL; chunk++)
+		bytes += sizeof(atomEntry) << (ATOM_FIRST_CHUNK_BITS + chunk);
+	for (atomIndex *index = atomic_load_explicit(&table.index, memory_order_relaxed); index != NULL; index = index->previous)
+		bytes += sizeof(atomIndex) + index->num_slots * sizeof(atom);
+	for (atomPoolBlock *block = table.pool; block != NULL; block = block->next)
+		bytes += sizeof(atomPoolBlock) + block->capacity;
+	pthread_mutex_unlock(&table_mutex);
+	return bytes;
+}
+
+int atom_count(void)
+{
+	return atomic_load_explicit(&table.count, memory_order_acquire);
+}
@@ -0,0 +1,96 @@
+/**
+ * @file Bitset.c
+ * @brief Arrays of bits packed in 64-bit words, with word-parallel operations.
+ * @version 1
+ * @date 2026-10-15
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#include "Bitset.h"
+#include <stdlib.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+size_t bitset_num_words(size_t num_bits)
+{
+	return (num_bits + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS;
+}
+
+uint64_t *bitset_create(size_t num_bits)
+{
+	size_t num_words = bitset_num_words(num_bits);
+	return (uint64_t *)calloc(num_words == 0 ? 1 : num_words, sizeof(uint64_t));
+}
+
+void bitset_set(uint64_t *bits, size_t index)
+{
+	bits[index / BITSET_WORD_BITS] |= (uint64_t)1 << (index % BITSET_WORD_BITS);
+}
+
+void bitset_clear(uint64_t *bits, size_t index)
+{
+	bits[index / BITSET_WORD_BITS] &= ~((uint64_t)1 << (index % BITSET_WORD_BITS));
+}
+
+bool bitset_test(const uint64_t *bits, size_t index)
+{
+	return (bits[index / BITSET_WORD_BITS] >> (index % BITSET_WORD_BITS)) & 1;
+}
+
+size_t bitset_popcount(const uint64_t *bits, size_t num_words)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < num_words; i++)
+		count += __builtin_popcountll(bits[i]);
+	return count;
+}
+
+bool bitset_intersects(const uint64_t *first, const uint64_t *second, size_t num_words)
+{
+	size_t i = 0;
+#ifdef __AVX2__
+	for (; i + 4 <= num_words; i += 4)
+	{
+		__m256i a = _mm256_loadu_si256((const __m256i *)(first + i));
+		__m256i b = _mm256_loadu_si256((const __m256i *)(second + i));
+		if (!_mm256_testz_si256(a, b))
+			return true;
+	}
+#endif
+	for (; i < num_words; i++)
+		if ((first[i] & second[i]) != 0)
+			return true;
+	return false;
+}
+
+size_t bitset_and(uint64_t *result, const uint64_t *first, const uint64_t *second, size_t num_words)
+{
+	size_t count = 0;
+	size_t i = 0;
+#ifdef __AVX2__
+	for (; i + 4 <= num_words; i += 4)
+	{
+		__m256i a = _mm256_loadu_si256((const __m256i *)(first + i));
+		__m256i b = _mm256_loadu_si256((const __m256i *)(second + i));
+		_mm256_storeu_si256((__m256i *)(result + i), _mm256_and_si256(a, b));
+		count += __builtin_popcountll(result[i]) + __builtin_popcountll(result[i + 1]) + __builtin_popcountll(result[i + 2]) + __builtin_popcountll(result[i + 3]);
+	}
+#endif
+	for (; i < num_words; i++)
+	{
+		result[i] = first[i] & second[i];
+		count += __builtin_popcountll(result[i]);
+	}
+	return count;
+}
+
+long bitset_first(const uint64_t *bits, size_t num_words)
+{
+	for (size_t i = 0; i < num_words; i++)
+		if (bits[i] != 0)
+			return (long)(i * BITSET_WORD_BITS + __builtin_ctzll(bits[i]));
+	return -1;
+}
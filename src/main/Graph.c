@@ -12,24 +12,111 @@
  */
 
 #include "Graph.h"
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 
-parameterList *parameter_list_add_parameter(parameterList *list, char *name, char *value)
+/**
+ * @brief Allocates a parameter list cell holding the interned strings of @p name and @p value.
+ *
+ * @param arena The arena in which the cell is allocated.
+ * @param name_atom The atom of the name.
+ * @param value_atom The atom of the value.
+ * @return parameterList* The cell (its next field is NULL).
+ */
+static parameterList *parameter_list_cell(Arena arena, atom name_atom, atom value_atom)
 {
-	if (list == NULL)
+	parameterList *cell = (parameterList *)arena_alloc(arena, sizeof(parameterList));
+	cell->name_atom = name_atom;
+	cell->value_atom = value_atom;
+	cell->name = atom_string(name_atom);
+	cell->value = atom_string(value_atom);
+	cell->span = NULL;
+	cell->span_length = 0;
+	cell->next = NULL;
+	return cell;
+}
+
+/**
+ * @brief Allocates a parameter list cell holding the interned string of @p name and the span of a value not yet decoded.
+ *
+ * @param arena The arena in which the cell is allocated.
+ * @param name_atom The atom of the name.
+ * @param span The characters of the value.
+ * @param length Their number.
+ * @return parameterList* The cell (its next field is NULL).
+ */
+static parameterList *parameter_list_span_cell(Arena arena, atom name_atom, const char *span, int length)
+{
+	parameterList *cell = (parameterList *)arena_alloc(arena, sizeof(parameterList));
+	cell->name_atom = name_atom;
+	cell->value_atom = NO_ATOM;
+	cell->name = atom_string(name_atom);
+	cell->value = NULL;
+	cell->span = span;
+	cell->span_length = length;
+	cell->next = NULL;
+	return cell;
+}
+
+/**
+ * @brief Interns the value of a cell if it is still kept as a span.
+ *
+ * @param cell A parameter list cell.
+ */
+static void parameter_decode(parameterList *cell)
+{
+	if (cell->span == NULL)
+		return;
+	cell->value_atom = atom_intern_length(cell->span, cell->span_length);
+	cell->value = atom_string(cell->value_atom);
+	cell->span = NULL;
+}
+
+/**
+ * @brief Returns the last link of @p list (the address of its final NULL pointer), or NULL if it contains a parameter named @p name_atom.
+ *
+ * @param list A parameter list (address of its first pointer).
+ * @param name_atom The atom of a name.
+ * @return parameterList** The last link, or NULL.
+ */
+static parameterList **parameter_list_end(parameterList **list, atom name_atom)
+{
+	while (*list != NULL)
 	{
-		list = (parameterList *)malloc(sizeof(parameterList));
-		list->name = (char *)malloc((strlen(name) + 1) * sizeof(char));
-		strcpy(list->name, name);
-		list->value = (char *)malloc((strlen(value) + 1) * sizeof(char));
-		strcpy(list->value, value);
-		list->next = NULL;
-		return list;
+		if ((*list)->name_atom == name_atom)
+			return NULL;
+		list = &(*list)->next;
 	}
-	else if (strcmp(name, list->name) != 0)
-		list->next = parameter_list_add_parameter(list->next, name, value);
+	return list;
+}
+
+parameterList *parameter_list_add_atoms(Arena arena, parameterList *list, atom name_atom, atom value_atom)
+{
+	parameterList **last = parameter_list_end(&list, name_atom);
+	if (last != NULL)
+		*last = parameter_list_cell(arena, name_atom, value_atom);
+	return list;
+}
+
+parameterList *parameter_list_add_span(Arena arena, parameterList *list, atom name_atom, const char *value, int length)
+{
+	parameterList **last = parameter_list_end(&list, name_atom);
+	if (last != NULL)
+		*last = parameter_list_span_cell(arena, name_atom, value, length);
+	return list;
+}
+
+parameterList *parameter_list_add_parameter(Arena arena, parameterList *list, char *name, char *value)
+{
+	return parameter_list_add_atoms(arena, list, atom_intern(name), atom_intern(value));
+}
+
+parameterList *parameter_list_decode(parameterList *list)
+{
+	for (parameterList *cell = list; cell != NULL; cell = cell->next)
+		parameter_decode(cell);
 	return list;
 }
 
@@ -37,49 +124,371 @@ parameterList *parameter_lists_merge(parameterList *head, parameterList *tail)
 {
 	if (head == NULL)
 		return tail;
-	if (head->next != NULL)
-	{
-		parameter_lists_merge(head->next, tail);
-		return head;
-	}
-	head->next = tail;
+	parameterList *last = head;
+	while (last->next != NULL)
+		last = last->next;
+	last->next = tail;
 	return head;
 }
 
-parameterList *parameter_list_copy(parameterList *source)
+parameterList *parameter_list_copy(Arena arena, parameterList *source)
 {
-	if (source == NULL)
-		return NULL;
-	parameterList *result = (parameterList *)malloc(sizeof(parameterList));
-	result->name = (char *)malloc((strlen(source->name) + 1) * sizeof(char));
-	strcpy(result->name, source->name);
-	result->value = (char *)malloc((strlen(source->value) + 1) * sizeof(char));
-	strcpy(result->value, source->value);
-	result->next = parameter_list_copy(source->next);
+	parameterList *result = NULL;
+	parameterList **last = &result;
+	for (; source != NULL; source = source->next)
+	{
+		if (source->span != NULL)
+			*last = parameter_list_span_cell(arena, source->name_atom, source->span, source->span_length);
+		else
+			*last = parameter_list_cell(arena, source->name_atom, source->value_atom);
+		last = &(*last)->next;
+	}
 	return result;
 }
 
 char *parameter_list_get_value(parameterList *list, char *name)
 {
-	while (list != NULL && strcmp(list->name, name) != 0)
-		list = list->next;
-	if (list == NULL)
+	atom value = parameter_list_get_atom(list, atom_lookup(name));
+	if (value == NO_ATOM)
 	{
 		return NULL;
 		/* printf("Parameter list does not contain required field %s\n", name);
 		exit(-1); */
 	}
-	return list->value;
+	return atom_string(value);
 }
 
-void parameter_list_delete(parameterList *list)
+atom parameter_list_get_atom(parameterList *list, atom name)
 {
+	while (list != NULL && list->name_atom != name)
+		list = list->next;
 	if (list == NULL)
+		return NO_ATOM;
+	parameter_decode(list);
+	return list->value_atom;
+}
+
+/**
+ * @brief Distributes @p values into the rows given by @p keys, producing a compressed sparse row index. Inside a row, values keep their order in the input.
+ *
+ * @param num_nodes The number of rows.
+ * @param num_pairs The number of values.
+ * @param keys The row of each value.
+ * @param values The values to distribute.
+ * @param offsets Array of size @p num_nodes + 1 receiving the start of each row.
+ * @param entries Array of size @p num_pairs receiving the values.
+ */
+static void csr_distribute(int num_nodes, size_t num_pairs, const int *keys, const int *values, size_t *offsets, int *entries)
+{
+	for (int row = 0; row <= num_nodes; row++)
+		offsets[row] = 0;
+	for (size_t i = 0; i < num_pairs; i++)
+		offsets[keys[i] + 1]++;
+	for (int row = 0; row < num_nodes; row++)
+		offsets[row + 1] += offsets[row];
+
+	size_t *next = (size_t *)malloc((num_nodes + 1) * sizeof(size_t));
+	memcpy(next, offsets, (num_nodes + 1) * sizeof(size_t));
+	for (size_t i = 0; i < num_pairs; i++)
+		entries[next[keys[i]]++] = values[i];
+	free(next);
+}
+
+/**
+ * @brief Returns an array giving, for each entry of a compressed sparse row index, the row it belongs to. Must be freed by the caller.
+ *
+ * @param num_nodes The number of rows.
+ * @param offsets The offsets of the index.
+ * @return int* The row of each entry.
+ */
+static int *csr_rows(int num_nodes, const size_t *offsets)
+{
+	int *rows = (int *)malloc((offsets[num_nodes] + 1) * sizeof(int));
+	for (int row = 0; row < num_nodes; row++)
+		for (size_t i = offsets[row]; i < offsets[row + 1]; i++)
+			rows[i] = row;
+	return rows;
+}
+
+/**
+ * @brief Removes the repeated entries of the rows of a compressed sparse row index, whose rows are sorted, in place.
+ *
+ * @param num_nodes The number of rows.
+ * @param offsets The offsets of the index, updated.
+ * @param entries The entries of the index, compacted.
+ * @return size_t The number of entries left.
+ */
+static size_t csr_unique(int num_nodes, size_t *offsets, int *entries)
+{
+	size_t used = 0;
+	size_t first = offsets[0];
+	for (int row = 0; row < num_nodes; row++)
+	{
+		size_t last = offsets[row + 1];
+		offsets[row] = used;
+		for (size_t i = first; i < last; i++)
+			if (i == first || entries[i] != entries[i - 1])
+				entries[used++] = entries[i];
+		first = last;
+	}
+	offsets[num_nodes] = used;
+	return used;
+}
+
+/**
+ * @brief Hashes a name of node for the name index. Names made of decimal digits (without leading zero) are hashed from their value.
+ *
+ * @param name A name of node (need not be null-terminated).
+ * @param length Its length.
+ * @return uint64_t Its hash.
+ */
+static uint64_t node_name_hash(const char *name, size_t length)
+{
+	if (length > 0 && length < 20 && (name[0] != '0' || length == 1))
+	{
+		uint64_t value = 0;
+		size_t i = 0;
+		while (i < length && name[i] >= '0' && name[i] <= '9')
+			value = 10 * value + (uint64_t)(name[i++] - '0');
+		if (i == length)
+			return value * 0x9E3779B97F4A7C15ULL;
+	}
+	// FNV-1a, with the top bit set so that it differs from numeric hashes.
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < length; i++)
+		hash = (hash ^ (unsigned char)name[i]) * 1099511628211ULL;
+	return hash | (1ULL << 63);
+}
+
+size_t graph_name_slot(const char *name, size_t length, size_t capacity)
+{
+	return (size_t)(node_name_hash(name, length) >> 32) & (capacity - 1);
+}
+
+int graph_find_node(Graph graph, const char *name)
+{
+	size_t slot = graph_name_slot(name, strlen(name), graph.name_slots_capacity);
+	while (graph.name_slots[slot] != -1)
+	{
+		if (strcmp(graph.nodes[graph.name_slots[slot]], name) == 0)
+			return graph.name_slots[slot];
+		slot = (slot + 1) & (graph.name_slots_capacity - 1);
+	}
+	return -1;
+}
+
+void graph_build_adjacency(Graph *graph, const int *sources, const int *targets, size_t num_pairs)
+{
+	int num_nodes = graph->numNodes;
+	Arena arena = graph->structure_arena;
+	graph->out_offsets = (size_t *)arena_alloc(arena, (num_nodes + 1) * sizeof(size_t));
+	graph->out_targets = (int *)arena_alloc(arena, num_pairs * sizeof(int));
+	graph->in_offsets = (size_t *)arena_alloc(arena, (num_nodes + 1) * sizeof(size_t));
+	graph->in_sources = (int *)arena_alloc(arena, num_pairs * sizeof(int));
+
+	// Two stable counting sorts give sorted rows: first by target, then by source (and conversely).
+	csr_distribute(num_nodes, num_pairs, targets, sources, graph->in_offsets, graph->in_sources);
+	int *rows = csr_rows(num_nodes, graph->in_offsets);
+	csr_distribute(num_nodes, num_pairs, graph->in_sources, rows, graph->out_offsets, graph->out_targets);
+	free(rows);
+	// Repeated edges are next to each other in the sorted rows.
+	num_pairs = csr_unique(num_nodes, graph->out_offsets, graph->out_targets);
+	rows = csr_rows(num_nodes, graph->out_offsets);
+	csr_distribute(num_nodes, num_pairs, graph->out_targets, rows, graph->in_offsets, graph->in_sources);
+	free(rows);
+
+	graph->edge_bits = NULL;
+	graph->edge_bits_words = 0;
+	graph->node_actions = NULL;
+	graph->initial = -1;
+	graph->final = -1;
+}
+
+/**
+ * @brief Copies @p size bytes from @p source in @p arena.
+ *
+ * @param arena An arena.
+ * @param source The memory to copy.
+ * @param size Its size.
+ * @return void* The copy.
+ */
+static void *arena_copy(Arena arena, const void *source, size_t size)
+{
+	return memcpy(arena_alloc(arena, size), source, size);
+}
+
+/**
+ * @brief Gives @p graph its own copy of its structure (in a new arena) if it is shared with other graphs, before modifying it.
+ *
+ * @param graph A graph.
+ */
+static void graph_detach_structure(Graph *graph)
+{
+	if (!arena_is_shared(graph->structure_arena))
+		return;
+	Arena arena = arena_create();
+	arena_release(graph->structure_arena);
+	graph->structure_arena = arena;
+
+	if (graph->name != NULL)
+		graph->name = arena_strdup(arena, graph->name);
+	char **nodes = (char **)arena_alloc(arena, graph->numNodes * sizeof(char *));
+	for (int i = 0; i < graph->numNodes; i++)
+		nodes[i] = arena_strdup(arena, graph->nodes[i]);
+	graph->nodes = nodes;
+	graph->name_slots = (int *)arena_copy(arena, graph->name_slots, graph->name_slots_capacity * sizeof(int));
+	if (graph->edges != NULL)
+		graph->edges = (bool *)arena_copy(arena, graph->edges, (size_t)graph->numNodes * graph->numNodes * sizeof(bool));
+
+	size_t num_adjacent = graph->out_offsets[graph->numNodes];
+	graph->out_offsets = (size_t *)arena_copy(arena, graph->out_offsets, (graph->numNodes + 1) * sizeof(size_t));
+	graph->out_targets = (int *)arena_copy(arena, graph->out_targets, num_adjacent * sizeof(int));
+	graph->in_offsets = (size_t *)arena_copy(arena, graph->in_offsets, (graph->numNodes + 1) * sizeof(size_t));
+	graph->in_sources = (int *)arena_copy(arena, graph->in_sources, num_adjacent * sizeof(int));
+	if (graph->edge_bits != NULL)
+		graph->edge_bits = (uint64_t *)arena_copy(arena, graph->edge_bits, (size_t)graph->numNodes * graph->edge_bits_words * sizeof(uint64_t));
+	if (graph->node_actions != NULL)
+		graph->node_actions = (int *)arena_copy(arena, graph->node_actions, graph->numNodes * sizeof(int));
+}
+
+void graph_build_edge_bits(Graph *graph)
+{
+	if (graph->edge_bits != NULL)
 		return;
-	parameter_list_delete(list->next);
-	free(list->name);
-	free(list->value);
-	free(list);
+	graph_detach_structure(graph);
+	graph->edge_bits_words = bitset_num_words(graph->numNodes);
+	size_t num_words = (size_t)graph->numNodes * graph->edge_bits_words;
+	graph->edge_bits = (uint64_t *)memset(arena_alloc(graph->structure_arena, num_words * sizeof(uint64_t)), 0, num_words * sizeof(uint64_t));
+	for (int node = 0; node < graph->numNodes; node++)
+	{
+		uint64_t *row = graph->edge_bits + (size_t)node * graph->edge_bits_words;
+		for (size_t i = graph->out_offsets[node]; i < graph->out_offsets[node + 1]; i++)
+			bitset_set(row, graph->out_targets[i]);
+	}
+}
+
+/**
+ * @brief Hashes an edge for the table of edge parameters.
+ *
+ * @param source The source of the edge.
+ * @param target The target of the edge.
+ * @param capacity The capacity of the table (a power of 2).
+ * @return size_t The first slot to probe.
+ */
+static size_t edge_parameter_hash(int source, int target, size_t capacity)
+{
+	uint64_t key = ((uint64_t)(uint32_t)source << 32) | (uint32_t)target;
+	key *= 0x9E3779B97F4A7C15ULL;
+	return (size_t)(key ^ (key >> 29)) & (capacity - 1);
+}
+
+/**
+ * @brief Finds the slot of edge (@p source, @p target) in @p table, or the free slot where it should be inserted.
+ *
+ * @param table A table with at least one free slot.
+ * @param source The source of the edge.
+ * @param target The target of the edge.
+ * @return edgeParameterSlot* The slot found.
+ */
+static edgeParameterSlot *edge_parameter_find_slot(const edgeParameterTable *table, int source, int target)
+{
+	size_t slot = edge_parameter_hash(source, target, table->capacity);
+	while (table->slots[slot].source != -1 && (table->slots[slot].source != source || table->slots[slot].target != target))
+		slot = (slot + 1) & (table->capacity - 1);
+	return &table->slots[slot];
+}
+
+/**
+ * @brief Allocates @p capacity free slots in the arena of @p table, and moves the previous entries in them. The previous slots stay in the arena: as the capacity doubles, they never take more memory than the current ones.
+ *
+ * @param table A table.
+ * @param capacity The new capacity (a power of 2 larger than table->size).
+ */
+static void edge_parameter_table_resize(edgeParameterTable *table, size_t capacity)
+{
+	edgeParameterSlot *old_slots = table->slots;
+	size_t old_capacity = table->capacity;
+	table->slots = (edgeParameterSlot *)arena_alloc(table->arena, capacity * sizeof(edgeParameterSlot));
+	table->capacity = capacity;
+	for (size_t i = 0; i < capacity; i++)
+		table->slots[i].source = -1;
+	for (size_t i = 0; i < old_capacity; i++)
+		if (old_slots[i].source != -1)
+			*edge_parameter_find_slot(table, old_slots[i].source, old_slots[i].target) = old_slots[i];
+}
+
+/**
+ * @brief Gives @p table its own copy of its slots and of their parameter lists (in a new arena) if they are shared with other graphs, before modifying it.
+ *
+ * @param table A table.
+ */
+static void edge_parameter_table_detach(edgeParameterTable *table)
+{
+	if (!arena_is_shared(table->arena))
+		return;
+	Arena arena = arena_create();
+	arena_release(table->arena);
+	table->arena = arena;
+	if (table->capacity == 0)
+		return;
+	edgeParameterSlot *slots = (edgeParameterSlot *)arena_alloc(arena, table->capacity * sizeof(edgeParameterSlot));
+	for (size_t i = 0; i < table->capacity; i++)
+	{
+		slots[i] = table->slots[i];
+		if (slots[i].source != -1)
+			slots[i].parameters = parameter_list_copy(arena, slots[i].parameters);
+	}
+	table->slots = slots;
+}
+
+void graph_set_edge_parameter(Graph *graph, int source, int target, parameterList *parameters)
+{
+	edgeParameterTable *table = &graph->edge_parameters;
+	edge_parameter_table_detach(table);
+	if (table->capacity == 0)
+	{
+		if (parameters == NULL)
+			return;
+		edge_parameter_table_resize(table, 16);
+	}
+	edgeParameterSlot *slot = edge_parameter_find_slot(table, source, target);
+	if (slot->source != -1)
+	{
+		slot->parameters = parameter_list_copy(table->arena, parameters);
+		return;
+	}
+	if (parameters == NULL)
+		return;
+	slot->source = source;
+	slot->target = target;
+	slot->parameters = parameter_list_copy(table->arena, parameters);
+	table->size++;
+	if (2 * table->size > table->capacity)
+		edge_parameter_table_resize(table, 2 * table->capacity);
+}
+
+void graph_build_node_parameters(Graph *graph, parameterList **lists)
+{
+	size_t total = 0;
+	for (int node = 0; node < graph->numNodes; node++)
+		for (parameterList *param = lists[node]; param != NULL; param = param->next)
+			total++;
+
+	graph->parameters = (parameterList **)arena_alloc(graph->parameters_arena, graph->numNodes * sizeof(parameterList *));
+	graph->parameter_block = (parameterList *)arena_alloc(graph->parameters_arena, total * sizeof(parameterList));
+	size_t used = 0;
+	for (int node = 0; node < graph->numNodes; node++)
+	{
+		graph->parameters[node] = NULL;
+		for (parameterList *param = lists[node]; param != NULL; param = param->next)
+		{
+			parameterList *cell = &graph->parameter_block[used++];
+			*cell = *param;
+			cell->next = param->next == NULL ? NULL : cell + 1;
+			if (graph->parameters[node] == NULL)
+				graph->parameters[node] = cell;
+		}
+	}
 }
 
 void graph_print(Graph graph)
@@ -94,7 +503,7 @@ void graph_print(Graph graph)
 	{
 		for (int j = 0; j < graph.numNodes; j++)
 		{
-			printf("%d ", graph.edges[i * graph.numNodes + j]);
+			printf("%d ", graph_is_edge(graph, i, j));
 		}
 		printf("\n");
 	}
@@ -105,7 +514,7 @@ void graph_print(Graph graph)
 	for (int i = 0; i < graph.numNodes; i++)
 	{
 		printf("node %s:", graph.nodes[i]);
-		parameterList *list = graph.parameters[i];
+		parameterList *list = graph_get_node_parameter(graph, i);
 		while (list != NULL)
 		{
 			printf("(%s : %s), ", list->name, list->value);
@@ -117,83 +526,213 @@ void graph_print(Graph graph)
 
 Graph graph_copy(Graph graph)
 {
-	Graph copy;
-	copy.name = graph.name;
-	copy.numNodes = graph.numNodes;
-	copy.numEdges = graph.numEdges;
-	copy.nodes = (char **)malloc(copy.numNodes * sizeof(char *));
-	copy.edges = (bool *)malloc(copy.numNodes * copy.numNodes * sizeof(bool));
+	arena_retain(graph.structure_arena);
+	arena_retain(graph.parameters_arena);
+	arena_retain(graph.edge_parameters.arena);
+	if (graph.source_arena != NULL)
+		arena_retain(graph.source_arena);
+	return graph;
+}
 
-	for (int i = 0; i < copy.numNodes * copy.numNodes; i++)
-		copy.edges[i] = graph.edges[i];
+void graph_delete(Graph graph)
+{
+	arena_release(graph.structure_arena);
+	arena_release(graph.parameters_arena);
+	arena_release(graph.edge_parameters.arena);
+	if (graph.source_arena != NULL)
+		arena_release(graph.source_arena);
+}
 
-	copy.parameters = (parameterList **)malloc(graph.numNodes * sizeof(parameterList *));
-	for (int i = 0; i < graph.numNodes; i++)
-		copy.parameters[i] = parameter_list_copy(graph.parameters[i]);
+char *graph_get_name(Graph graph)
+{
+	return graph.name;
+}
 
-	copy.edge_parameters = (parameterList **)malloc(graph.numNodes * graph.numNodes * sizeof(parameterList *));
-	for (int i = 0; i < graph.numNodes * graph.numNodes; i++)
-		copy.edge_parameters[i] = parameter_list_copy(graph.edge_parameters[i]);
+int graph_num_nodes(Graph graph)
+{
+	return graph.numNodes;
+}
 
-	return copy;
+int graph_num_edges(Graph graph)
+{
+	return graph.numEdges;
 }
 
-void graph_delete(Graph graph)
+bool graph_is_edge(Graph graph, int source, int target)
 {
 	if (graph.edges != NULL)
-		free(graph.edges);
-	if (graph.nodes != NULL)
+		return graph.edges[((size_t)source * graph.numNodes) + target];
+	if (graph.edge_bits != NULL)
+		return bitset_test(graph.edge_bits + (size_t)source * graph.edge_bits_words, target);
+	// The successors of a node are sorted.
+	size_t low = graph.out_offsets[source];
+	size_t high = graph.out_offsets[source + 1];
+	while (low < high)
 	{
-		for (int i = 0; i < graph.numNodes; i++)
-		{
-			if (graph.nodes[i] != NULL)
-				free(graph.nodes[i]);
-		}
-		free(graph.nodes);
+		size_t middle = low + (high - low) / 2;
+		if (graph.out_targets[middle] < target)
+			low = middle + 1;
+		else
+			high = middle;
 	}
-	// Pour les automates.
+	return low < graph.out_offsets[source + 1] && graph.out_targets[low] == target;
+}
 
-	for (int i = 0; i < graph.numNodes; i++)
-		parameter_list_delete(graph.parameters[i]);
-	free(graph.parameters);
+size_t graph_out_neighbours(Graph graph, int node, const int **neighbours)
+{
+	*neighbours = graph.out_targets + graph.out_offsets[node];
+	return graph.out_offsets[node + 1] - graph.out_offsets[node];
+}
 
-	for (int i = 0; i < graph.numNodes * graph.numNodes; i++)
-		parameter_list_delete(graph.edge_parameters[i]);
-	free(graph.edge_parameters);
+size_t graph_in_neighbours(Graph graph, int node, const int **neighbours)
+{
+	*neighbours = graph.in_sources + graph.in_offsets[node];
+	return graph.in_offsets[node + 1] - graph.in_offsets[node];
+}
 
-	graph.numEdges = 0;
-	graph.numNodes = 0;
-	free(graph.name);
+size_t graph_out_degree(Graph graph, int node)
+{
+	return graph.out_offsets[node + 1] - graph.out_offsets[node];
 }
 
-char *graph_get_name(Graph graph)
+size_t graph_in_degree(Graph graph, int node)
 {
-	return graph.name;
+	return graph.in_offsets[node + 1] - graph.in_offsets[node];
 }
 
-int graph_num_nodes(Graph graph)
+/**
+ * @brief Breadth-first search from @p start following a compressed sparse row index.
+ *
+ * @param num_nodes The number of nodes.
+ * @param offsets The index of the rows.
+ * @param entries The rows.
+ * @param start The first node.
+ * @param reached Set to true exactly for the nodes reached.
+ * @return int The number of nodes reached.
+ */
+static int csr_search(int num_nodes, const size_t *offsets, const int *entries, int start, bool *reached)
 {
-	return graph.numNodes;
+	for (int node = 0; node < num_nodes; node++)
+		reached[node] = false;
+	int *queue = (int *)malloc(num_nodes * sizeof(int));
+	int head = 0;
+	int tail = 0;
+	reached[start] = true;
+	queue[tail++] = start;
+	while (head < tail)
+	{
+		int node = queue[head++];
+		for (size_t i = offsets[node]; i < offsets[node + 1]; i++)
+			if (!reached[entries[i]])
+			{
+				reached[entries[i]] = true;
+				queue[tail++] = entries[i];
+			}
+	}
+	free(queue);
+	return tail;
 }
 
-int graph_num_edges(Graph graph)
+int graph_reachable(Graph graph, int source, bool *reached)
 {
-	return graph.numEdges;
+	return csr_search(graph.numNodes, graph.out_offsets, graph.out_targets, source, reached);
 }
 
-bool graph_is_edge(Graph graph, int source, int target)
+int graph_coreachable(Graph graph, int target, bool *reached)
+{
+	return csr_search(graph.numNodes, graph.in_offsets, graph.in_sources, target, reached);
+}
+
+bool graph_has_edge_bits(Graph graph)
 {
-	return graph.edges[(source * graph.numNodes) + target];
+	return graph.edge_bits != NULL;
+}
+
+size_t graph_edge_bits_words(Graph graph)
+{
+	return graph.edge_bits_words;
+}
+
+const uint64_t *graph_edge_bits_row(Graph graph, int node)
+{
+	return graph.edge_bits + (size_t)node * graph.edge_bits_words;
+}
+
+size_t graph_bits_degree(Graph graph, int node)
+{
+	return bitset_popcount(graph_edge_bits_row(graph, node), graph.edge_bits_words);
+}
+
+size_t graph_common_neighbours(Graph graph, int first, int second, uint64_t *result)
+{
+	return bitset_and(result, graph_edge_bits_row(graph, first), graph_edge_bits_row(graph, second), graph.edge_bits_words);
+}
+
+int graph_greedy_clique_size(Graph graph)
+{
+	if (graph.edge_bits == NULL)
+		return 0;
+	size_t words = graph.edge_bits_words;
+	uint64_t *candidates = bitset_create(words * BITSET_WORD_BITS);
+	uint64_t *scratch = bitset_create(words * BITSET_WORD_BITS);
+	int best = graph.numNodes > 0 ? 1 : 0;
+
+	// From each node, repeatedly adds the candidate adjacent to the most other candidates.
+	for (int start = 0; start < graph.numNodes; start++)
+	{
+		if ((int)graph_bits_degree(graph, start) < best)
+			continue;
+		memcpy(candidates, graph_edge_bits_row(graph, start), words * sizeof(uint64_t));
+		bitset_clear(candidates, start);
+		int size = 1;
+		while (bitset_first(candidates, words) != -1)
+		{
+			int chosen = -1;
+			size_t chosen_count = 0;
+			for (size_t word = 0; word < words; word++)
+			{
+				for (uint64_t bits = candidates[word]; bits != 0; bits &= bits - 1)
+				{
+					int node = (int)(word * BITSET_WORD_BITS + __builtin_ctzll(bits));
+					size_t count = bitset_and(scratch, candidates, graph_edge_bits_row(graph, node), words);
+					if (chosen == -1 || count > chosen_count)
+					{
+						chosen = node;
+						chosen_count = count;
+					}
+				}
+			}
+			bitset_clear(candidates, chosen);
+			bitset_and(candidates, candidates, graph_edge_bits_row(graph, chosen), words);
+			size++;
+		}
+		if (size > best)
+			best = size;
+	}
+
+	free(candidates);
+	free(scratch);
+	return best;
 }
 
 parameterList *graph_get_edge_parameter(Graph graph, int source, int target)
 {
-	return graph.edge_parameters[(source * graph.numNodes) + target];
+	if (graph.edge_parameters.capacity == 0)
+		return NULL;
+	edgeParameterSlot *slot = edge_parameter_find_slot(&graph.edge_parameters, source, target);
+	if (slot->source == -1)
+		return NULL;
+	return parameter_list_decode(slot->parameters);
 }
 
 parameterList *graph_get_node_parameter(Graph graph, int node)
 {
-	return graph.parameters[node];
+	return parameter_list_decode(graph.parameters[node]);
+}
+
+atom graph_get_node_attribute(Graph graph, int node, atom name)
+{
+	return parameter_list_get_atom(graph.parameters[node], name);
 }
 
 char *graph_get_node_name(Graph graph, int node)
@@ -201,6 +740,69 @@ char *graph_get_node_name(Graph graph, int node)
 	return graph.nodes[node];
 }
 
+void graph_set_node_actions(Graph *graph, const int *node_actions, int initial, int final)
+{
+	graph_detach_structure(graph);
+	graph->node_actions = (int *)arena_copy(graph->structure_arena, node_actions, graph->numNodes * sizeof(int));
+	graph->initial = initial;
+	graph->final = final;
+}
+
+const int *graph_get_node_actions(Graph graph)
+{
+	return graph.node_actions;
+}
+
+int graph_get_initial(Graph graph)
+{
+	return graph.initial;
+}
+
+int graph_get_final(Graph graph)
+{
+	return graph.final;
+}
+
+graphMemory graph_memory_usage(Graph graph)
+{
+	graphMemory memory;
+	size_t num_nodes = (size_t)graph.numNodes;
+	memory.edge_matrix = graph.edges == NULL ? 0 : num_nodes * num_nodes * sizeof(bool);
+	memory.adjacency = 2 * ((num_nodes + 1) * sizeof(size_t) + graph.out_offsets[num_nodes] * sizeof(int));
+	memory.edge_bits = graph.edge_bits == NULL ? 0 : num_nodes * graph.edge_bits_words * sizeof(uint64_t);
+	memory.names = num_nodes * sizeof(char *) + graph.name_slots_capacity * sizeof(int);
+	if (graph.name != NULL)
+		memory.names += strlen(graph.name) + 1;
+	for (int node = 0; node < graph.numNodes; node++)
+		memory.names += strlen(graph.nodes[node]) + 1;
+	memory.node_parameters = num_nodes * sizeof(parameterList *);
+	for (int node = 0; node < graph.numNodes; node++)
+		for (parameterList *param = graph.parameters[node]; param != NULL; param = param->next)
+			memory.node_parameters += sizeof(parameterList);
+	memory.edge_parameters = graph.edge_parameters.capacity * sizeof(edgeParameterSlot);
+	for (size_t i = 0; i < graph.edge_parameters.capacity; i++)
+		if (graph.edge_parameters.slots[i].source != -1)
+			for (parameterList *param = graph.edge_parameters.slots[i].parameters; param != NULL; param = param->next)
+				memory.edge_parameters += sizeof(parameterList);
+	memory.node_actions = graph.node_actions == NULL ? 0 : num_nodes * sizeof(int);
+	memory.arenas = arena_used(graph.structure_arena) + arena_used(graph.parameters_arena) + arena_used(graph.edge_parameters.arena);
+	return memory;
+}
+
+void graph_print_memory_usage(Graph graph)
+{
+	graphMemory memory = graph_memory_usage(graph);
+	printf("Memory of graph %s (%d nodes, %d edges), in bytes:\n", graph.name == NULL ? "" : graph.name, graph.numNodes, graph.numEdges);
+	printf("  edge matrix:     %zu\n", memory.edge_matrix);
+	printf("  adjacency:       %zu\n", memory.adjacency);
+	printf("  edge bits:       %zu\n", memory.edge_bits);
+	printf("  names:           %zu\n", memory.names);
+	printf("  node parameters: %zu\n", memory.node_parameters);
+	printf("  edge parameters: %zu\n", memory.edge_parameters);
+	printf("  node actions:    %zu\n", memory.node_actions);
+	printf("  arenas (total):  %zu\n", memory.arenas);
+}
+
 void graph_fill_dot_content(Graph graph, FILE *file)
 {
 	int num_nodes = graph.numNodes;
@@ -210,7 +812,7 @@ void graph_fill_dot_content(Graph graph, FILE *file)
 		if (graph.parameters[node] != NULL)
 		{
 			fprintf(file, "[");
-			parameterList *param = graph.parameters[node];
+			parameterList *param = graph_get_node_parameter(graph, node);
 			while (true)
 			{
 				fprintf(file, "%s=%s", param->name, param->value);
@@ -225,14 +827,14 @@ void graph_fill_dot_content(Graph graph, FILE *file)
 	}
 	for (int node = 0; node < num_nodes; node++)
 	{
-		for (int node2 = 0; node2 < node; node2++)
+		const int *neighbours;
+		size_t degree = graph_out_neighbours(graph, node, &neighbours);
+		for (size_t i = 0; i < degree && neighbours[i] < node; i++)
 		{
-			if (graph_is_edge(graph, node, node2))
-			{
-				fprintf(file, "%s -- %s", graph_get_node_name(graph, node), graph_get_node_name(graph, node2));
-				fprintf(file, ";\n");
-				// todo : edge parameters
-			}
+			int node2 = neighbours[i];
+			fprintf(file, "%s -- %s", graph_get_node_name(graph, node), graph_get_node_name(graph, node2));
+			fprintf(file, ";\n");
+			// todo : edge parameters
 		}
 	}
 }
@@ -246,7 +848,7 @@ void digraph_fill_dot_content(Graph graph, FILE *file)
 		if (graph.parameters[node] != NULL)
 		{
 			fprintf(file, "[");
-			parameterList *param = graph.parameters[node];
+			parameterList *param = graph_get_node_parameter(graph, node);
 			while (true)
 			{
 				fprintf(file, "%s=%s", param->name, param->value);
@@ -261,15 +863,15 @@ void digraph_fill_dot_content(Graph graph, FILE *file)
 	}
 	for (int node = 0; node < num_nodes; node++)
 	{
-		for (int node2 = 0; node2 < num_nodes; node2++)
+		const int *neighbours;
+		size_t degree = graph_out_neighbours(graph, node, &neighbours);
+		for (size_t i = 0; i < degree; i++)
 		{
-			if (graph_is_edge(graph, node, node2))
-			{
-				fprintf(file, "%s -> %s", graph_get_node_name(graph, node), graph_get_node_name(graph, node2));
-				fprintf(file, ";\n");
+			int node2 = neighbours[i];
+			fprintf(file, "%s -> %s", graph_get_node_name(graph, node), graph_get_node_name(graph, node2));
+			fprintf(file, ";\n");
 
-				// todo : edge parameters.
-			}
+			// todo : edge parameters.
 		}
 	}
 }
\ No newline at end of file
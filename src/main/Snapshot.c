@@ -0,0 +1,609 @@
+/**
+ * @file Snapshot.c
+ * @brief Compact binary format for parsed graphs, loaded by mapping the file in memory.
+ * @version 1
+ * @date 2026-10-15
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#include "Snapshot.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+_Static_assert(sizeof(size_t) == sizeof(uint64_t), "the adjacency offsets of a snapshot are used in place as size_t");
+_Static_assert(sizeof(int) == sizeof(int32_t), "the adjacency and the name index of a snapshot are used in place as int");
+
+/**
+ * @brief The first bytes of a snapshot.
+ *
+ */
+#define SNAPSHOT_MAGIC "COCASNAP"
+
+/**
+ * @brief The version of the format.
+ *
+ */
+#define SNAPSHOT_VERSION 2
+
+/**
+ * @brief Flag of the header: the snapshot contains the bit-packed adjacency of the graph.
+ *
+ */
+#define SNAPSHOT_EDGE_BITS 1
+
+/**
+ * @brief Flag of the header: the snapshot contains the masks of actions of the nodes, and the initial and final nodes.
+ *
+ */
+#define SNAPSHOT_NODE_ACTIONS 2
+
+/**
+ * @brief The sections of a snapshot, in the order they appear in the file. Each starts at an offset multiple of 8.
+ *
+ */
+typedef enum
+{
+	section_strings,                ///< All strings (name of the graph, of the nodes and interned parameters), each ending with '\0'.
+	section_node_names,             ///< For each node, the offset of its name in the strings (uint64_t).
+	section_atoms,                  ///< For each atom of the snapshot, the offset of its string in the strings (uint64_t).
+	section_out_offsets,            ///< The index of successors (uint64_t, numNodes + 1).
+	section_out_targets,            ///< The successors (int32_t).
+	section_in_offsets,             ///< The index of predecessors (uint64_t, numNodes + 1).
+	section_in_sources,             ///< The predecessors (int32_t).
+	section_node_parameter_offsets, ///< For each node, the index of its first parameter (uint64_t, numNodes + 1).
+	section_node_parameters,        ///< The parameters of the nodes, as pairs of atoms of the snapshot (int32_t).
+	section_edge_entries,           ///< The edges having parameters, as pairs (source, target) (int32_t).
+	section_edge_parameter_offsets, ///< For each edge having parameters, the index of its first parameter (uint64_t, entries + 1).
+	section_edge_parameters,        ///< The parameters of the edges, as pairs of atoms of the snapshot (int32_t).
+	section_node_actions,           ///< The masks of actions of the nodes (int32_t, empty without SNAPSHOT_NODE_ACTIONS).
+	section_name_slots,             ///< The hash index of the names of the nodes (int32_t, name_slots_capacity), used in place.
+	section_edge_bits,              ///< The bit-packed adjacency (uint64_t, numNodes rows of edge_bits_words, empty without SNAPSHOT_EDGE_BITS), used in place.
+	num_sections
+} snapshotSection;
+
+/**
+ * @brief The header at the beginning of a snapshot.
+ *
+ */
+typedef struct
+{
+	char magic[8];                      ///< SNAPSHOT_MAGIC.
+	uint32_t version;                   ///< SNAPSHOT_VERSION.
+	uint32_t flags;                     ///< SNAPSHOT_EDGE_BITS and SNAPSHOT_NODE_ACTIONS.
+	int32_t num_nodes;                  ///< The number of nodes.
+	int32_t num_edges;                  ///< The number of edges (numEdges field of the graph).
+	int32_t initial;                    ///< The initial node (-1 if not known).
+	int32_t final;                      ///< The final node (-1 if not known).
+	uint64_t name;                      ///< The offset of the name of the graph in the strings (UINT64_MAX if it has none).
+	uint64_t num_atoms;                 ///< The number of atoms of the snapshot.
+	uint64_t num_adjacent;              ///< The number of pairs in the adjacency.
+	uint64_t num_node_parameters;       ///< The number of parameters of nodes.
+	uint64_t num_edge_entries;          ///< The number of edges having parameters.
+	uint64_t num_edge_parameters;       ///< The number of parameters of edges.
+	uint64_t name_slots_capacity;       ///< The number of slots of the name index.
+	uint64_t sections[num_sections][2]; ///< The offset and size in bytes of each section.
+} snapshotHeader;
+
+/**
+ * @brief Growable buffer of strings, used while writing a snapshot.
+ *
+ */
+typedef struct
+{
+	char *data;      ///< The characters.
+	size_t size;     ///< The number of characters used.
+	size_t capacity; ///< The size of data.
+} snapshotStrings;
+
+/**
+ * @brief Appends @p string (with its '\0') to @p strings.
+ *
+ * @param strings A buffer of strings.
+ * @param string A string.
+ * @return uint64_t The offset of the string in the buffer.
+ */
+static uint64_t snapshot_add_string(snapshotStrings *strings, const char *string)
+{
+	size_t length = strlen(string) + 1;
+	if (strings->size + length > strings->capacity)
+	{
+		while (strings->size + length > strings->capacity)
+			strings->capacity = strings->capacity == 0 ? 4096 : 2 * strings->capacity;
+		strings->data = (char *)realloc(strings->data, strings->capacity);
+	}
+	memcpy(strings->data + strings->size, string, length);
+	strings->size += length;
+	return strings->size - length;
+}
+
+/**
+ * @brief Gets the atom of the snapshot standing for @p global, adding it (and its string) if it is new.
+ *
+ * @param global An atom.
+ * @param locals The atom of the snapshot of each atom (-1 if none yet).
+ * @param atom_offsets The offsets of the strings of the atoms of the snapshot (grown as needed).
+ * @param num_atoms The number of atoms of the snapshot.
+ * @param strings The strings of the snapshot.
+ * @return int32_t The atom of the snapshot.
+ */
+static int32_t snapshot_local_atom(atom global, int32_t *locals, uint64_t **atom_offsets, uint64_t *num_atoms, snapshotStrings *strings)
+{
+	if (locals[global] == -1)
+	{
+		*atom_offsets = (uint64_t *)realloc(*atom_offsets, (*num_atoms + 1) * sizeof(uint64_t));
+		(*atom_offsets)[*num_atoms] = snapshot_add_string(strings, atom_string(global));
+		locals[global] = (int32_t)(*num_atoms)++;
+	}
+	return locals[global];
+}
+
+/**
+ * @brief Writes a section at the end of @p file, after padding it to a multiple of 8 bytes.
+ *
+ * @param file A file.
+ * @param header The header, in which the offset and size of the section are recorded.
+ * @param section A section.
+ * @param data The content of the section.
+ * @param size Its size in bytes.
+ * @return true If it was written.
+ * @return false Otherwise.
+ */
+static bool snapshot_write_section(FILE *file, snapshotHeader *header, snapshotSection section, const void *data, size_t size)
+{
+	static const char padding[8] = {0};
+	long position = ftell(file);
+	if (position < 0 || fwrite(padding, 1, (8 - position % 8) % 8, file) != (size_t)((8 - position % 8) % 8))
+		return false;
+	header->sections[section][0] = (uint64_t)(position + (8 - position % 8) % 8);
+	header->sections[section][1] = size;
+	return size == 0 || fwrite(data, 1, size, file) == size;
+}
+
+bool snapshot_write(Graph graph, char *path)
+{
+	int num_nodes = graph_num_nodes(graph);
+	snapshotHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SNAPSHOT_MAGIC, 8);
+	header.version = SNAPSHOT_VERSION;
+	header.num_nodes = num_nodes;
+	header.num_edges = graph_num_edges(graph);
+	header.initial = graph_get_initial(graph);
+	header.name_slots_capacity = graph.name_slots_capacity;
+	header.final = graph_get_final(graph);
+	if (graph_has_edge_bits(graph))
+		header.flags |= SNAPSHOT_EDGE_BITS;
+	if (graph_get_node_actions(graph) != NULL)
+		header.flags |= SNAPSHOT_NODE_ACTIONS;
+
+	snapshotStrings strings = {NULL, 0, 0};
+	header.name = graph_get_name(graph) == NULL ? UINT64_MAX : snapshot_add_string(&strings, graph_get_name(graph));
+	uint64_t *node_names = (uint64_t *)malloc((num_nodes + 1) * sizeof(uint64_t));
+	for (int node = 0; node < num_nodes; node++)
+		node_names[node] = snapshot_add_string(&strings, graph_get_node_name(graph, node));
+
+	int32_t *locals = (int32_t *)malloc((atom_count() + 1) * sizeof(int32_t));
+	for (int i = 0; i < atom_count(); i++)
+		locals[i] = -1;
+	uint64_t *atom_offsets = NULL;
+
+	uint64_t *node_parameter_offsets = (uint64_t *)malloc((num_nodes + 1) * sizeof(uint64_t));
+	for (int node = 0; node < num_nodes; node++)
+	{
+		node_parameter_offsets[node] = header.num_node_parameters;
+		for (parameterList *param = graph_get_node_parameter(graph, node); param != NULL; param = param->next)
+			header.num_node_parameters++;
+	}
+	node_parameter_offsets[num_nodes] = header.num_node_parameters;
+	int32_t *node_parameters = (int32_t *)malloc((2 * header.num_node_parameters + 1) * sizeof(int32_t));
+	size_t used = 0;
+	for (int node = 0; node < num_nodes; node++)
+		for (parameterList *param = graph_get_node_parameter(graph, node); param != NULL; param = param->next)
+		{
+			node_parameters[used++] = snapshot_local_atom(param->name_atom, locals, &atom_offsets, &header.num_atoms, &strings);
+			node_parameters[used++] = snapshot_local_atom(param->value_atom, locals, &atom_offsets, &header.num_atoms, &strings);
+		}
+
+	edgeParameterTable *table = &graph.edge_parameters;
+	for (size_t i = 0; i < table->capacity; i++)
+		if (table->slots[i].source != -1 && table->slots[i].parameters != NULL)
+		{
+			header.num_edge_entries++;
+			for (parameterList *param = table->slots[i].parameters; param != NULL; param = param->next)
+				header.num_edge_parameters++;
+		}
+	int32_t *edge_entries = (int32_t *)malloc((2 * header.num_edge_entries + 1) * sizeof(int32_t));
+	uint64_t *edge_parameter_offsets = (uint64_t *)malloc((header.num_edge_entries + 1) * sizeof(uint64_t));
+	int32_t *edge_parameters = (int32_t *)malloc((2 * header.num_edge_parameters + 1) * sizeof(int32_t));
+	size_t entry = 0;
+	used = 0;
+	for (size_t i = 0; i < table->capacity; i++)
+		if (table->slots[i].source != -1 && table->slots[i].parameters != NULL)
+		{
+			edge_entries[2 * entry] = table->slots[i].source;
+			edge_entries[2 * entry + 1] = table->slots[i].target;
+			edge_parameter_offsets[entry++] = used / 2;
+			for (parameterList *param = parameter_list_decode(table->slots[i].parameters); param != NULL; param = param->next)
+			{
+				edge_parameters[used++] = snapshot_local_atom(param->name_atom, locals, &atom_offsets, &header.num_atoms, &strings);
+				edge_parameters[used++] = snapshot_local_atom(param->value_atom, locals, &atom_offsets, &header.num_atoms, &strings);
+			}
+		}
+	edge_parameter_offsets[entry] = used / 2;
+
+	header.num_adjacent = graph.out_offsets[num_nodes];
+	const int *node_actions = graph_get_node_actions(graph);
+
+	FILE *file = fopen(path, "wb");
+	bool written = file != NULL;
+	if (written)
+	{
+		written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+				  snapshot_write_section(file, &header, section_strings, strings.data, strings.size) &&
+				  snapshot_write_section(file, &header, section_node_names, node_names, num_nodes * sizeof(uint64_t)) &&
+				  snapshot_write_section(file, &header, section_atoms, atom_offsets, header.num_atoms * sizeof(uint64_t)) &&
+				  snapshot_write_section(file, &header, section_out_offsets, graph.out_offsets, (num_nodes + 1) * sizeof(uint64_t)) &&
+				  snapshot_write_section(file, &header, section_out_targets, graph.out_targets, header.num_adjacent * sizeof(int32_t)) &&
+				  snapshot_write_section(file, &header, section_in_offsets, graph.in_offsets, (num_nodes + 1) * sizeof(uint64_t)) &&
+				  snapshot_write_section(file, &header, section_in_sources, graph.in_sources, header.num_adjacent * sizeof(int32_t)) &&
+				  snapshot_write_section(file, &header, section_node_parameter_offsets, node_parameter_offsets, (num_nodes + 1) * sizeof(uint64_t)) &&
+				  snapshot_write_section(file, &header, section_node_parameters, node_parameters, 2 * header.num_node_parameters * sizeof(int32_t)) &&
+				  snapshot_write_section(file, &header, section_edge_entries, edge_entries, 2 * header.num_edge_entries * sizeof(int32_t)) &&
+				  snapshot_write_section(file, &header, section_edge_parameter_offsets, edge_parameter_offsets, (header.num_edge_entries + 1) * sizeof(uint64_t)) &&
+				  snapshot_write_section(file, &header, section_edge_parameters, edge_parameters, 2 * header.num_edge_parameters * sizeof(int32_t)) &&
+				  snapshot_write_section(file, &header, section_node_actions, node_actions, node_actions == NULL ? 0 : num_nodes * sizeof(int32_t)) &&
+				  snapshot_write_section(file, &header, section_name_slots, graph.name_slots, graph.name_slots_capacity * sizeof(int32_t)) &&
+				  snapshot_write_section(file, &header, section_edge_bits, graph.edge_bits, graph.edge_bits == NULL ? 0 : (size_t)num_nodes * graph.edge_bits_words * sizeof(uint64_t)) &&
+				  fseek(file, 0, SEEK_SET) == 0 &&
+				  fwrite(&header, sizeof(header), 1, file) == 1;
+		written = fclose(file) == 0 && written;
+	}
+
+	free(strings.data);
+	free(node_names);
+	free(locals);
+	free(atom_offsets);
+	free(node_parameter_offsets);
+	free(node_parameters);
+	free(edge_entries);
+	free(edge_parameter_offsets);
+	free(edge_parameters);
+	return written;
+}
+
+bool snapshot_detect(char *path)
+{
+	FILE *file = fopen(path, "rb");
+	if (file == NULL)
+		return false;
+	char magic[8];
+	bool result = fread(magic, 1, 8, file) == 8 && memcmp(magic, SNAPSHOT_MAGIC, 8) == 0;
+	fclose(file);
+	return result;
+}
+
+/**
+ * @brief A mapped file, unmapped when the arena of the structure of the graph using it is freed.
+ *
+ */
+typedef struct
+{
+	void *address; ///< The start of the mapping.
+	size_t length; ///< Its length.
+} snapshotMapping;
+
+/**
+ * @brief Unmaps a snapshot (cleanup function of an arena).
+ *
+ * @param data A snapshotMapping.
+ */
+static void snapshot_unmap(void *data)
+{
+	snapshotMapping *mapping = (snapshotMapping *)data;
+	munmap(mapping->address, mapping->length);
+}
+
+/**
+ * @brief Reports that @p path is not a valid snapshot.
+ *
+ * @param path The name of the file.
+ * @param reason What is wrong with it.
+ * @return false, to be returned by the loader.
+ */
+static bool snapshot_invalid(char *path, char *reason)
+{
+	printf("file %s is not a valid snapshot (%s).\n", path, reason);
+	return false;
+}
+
+/**
+ * @brief Checks one direction of the compressed sparse row adjacency of a mapped snapshot: the offsets go from 0 to the number of pairs without decreasing,
+ *        and the neighbours of each node are nodes, sorted by strictly increasing identifier (as built by graph_build_adjacency).
+ *
+ * @param offsets The offsets (num_nodes + 1).
+ * @param neighbours The neighbours.
+ * @param num_nodes The number of nodes.
+ * @param num_adjacent The number of pairs.
+ * @return true if the adjacency is valid.
+ */
+static bool snapshot_check_adjacency(const uint64_t *offsets, const int32_t *neighbours, uint64_t num_nodes, uint64_t num_adjacent)
+{
+	if (offsets[0] != 0 || offsets[num_nodes] != num_adjacent)
+		return false;
+	for (uint64_t node = 0; node < num_nodes; node++)
+	{
+		if (offsets[node] > offsets[node + 1])
+			return false;
+		for (uint64_t i = offsets[node]; i < offsets[node + 1]; i++)
+			if (neighbours[i] < 0 || (uint64_t)neighbours[i] >= num_nodes || (i > offsets[node] && neighbours[i] <= neighbours[i - 1]))
+				return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Checks the indices stored in the sections of a mapped snapshot, whose sizes have already been checked.
+ *
+ * @param base The mapping.
+ * @param header Its header.
+ * @param strings_size The size of the strings section.
+ * @return char* What is wrong with the snapshot, or NULL if it is valid.
+ */
+static char *snapshot_check_sections(const char *base, const snapshotHeader *header, uint64_t strings_size)
+{
+	uint64_t num_nodes = header->num_nodes;
+	if (header->initial < -1 || header->initial >= header->num_nodes || header->final < -1 || header->final >= header->num_nodes)
+		return "initial or final node out of bounds";
+	const uint64_t *node_names = (const uint64_t *)(base + header->sections[section_node_names][0]);
+	for (uint64_t node = 0; node < num_nodes; node++)
+		if (node_names[node] >= strings_size)
+			return "node name out of bounds";
+	const uint64_t *out_offsets = (const uint64_t *)(base + header->sections[section_out_offsets][0]);
+	const int32_t *out_targets = (const int32_t *)(base + header->sections[section_out_targets][0]);
+	const uint64_t *in_offsets = (const uint64_t *)(base + header->sections[section_in_offsets][0]);
+	const int32_t *in_sources = (const int32_t *)(base + header->sections[section_in_sources][0]);
+	if (!snapshot_check_adjacency(out_offsets, out_targets, num_nodes, header->num_adjacent) || !snapshot_check_adjacency(in_offsets, in_sources, num_nodes, header->num_adjacent))
+		return "inconsistent adjacency";
+
+	const uint64_t *atom_offsets = (const uint64_t *)(base + header->sections[section_atoms][0]);
+	for (uint64_t i = 0; i < header->num_atoms; i++)
+		if (atom_offsets[i] >= strings_size)
+			return "atom out of bounds";
+
+	const uint64_t *node_parameter_offsets = (const uint64_t *)(base + header->sections[section_node_parameter_offsets][0]);
+	const int32_t *node_parameters = (const int32_t *)(base + header->sections[section_node_parameters][0]);
+	for (uint64_t node = 0; node < num_nodes; node++)
+	{
+		uint64_t first = node_parameter_offsets[node];
+		uint64_t last = node_parameter_offsets[node + 1];
+		if (first > last || last > header->num_node_parameters)
+			return "inconsistent node parameters";
+		for (uint64_t i = first; i < last; i++)
+			if ((uint64_t)node_parameters[2 * i] >= header->num_atoms || (uint64_t)node_parameters[2 * i + 1] >= header->num_atoms)
+				return "unknown atom";
+	}
+
+	// The index holds one slot per node, so that it has free slots and looking a name up ends.
+	const int32_t *name_slots = (const int32_t *)(base + header->sections[section_name_slots][0]);
+	uint64_t capacity = header->name_slots_capacity;
+	if (capacity < 2 * num_nodes || capacity == 0 || (capacity & (capacity - 1)) != 0)
+		return "inconsistent name index";
+	uint64_t num_used_slots = 0;
+	for (uint64_t slot = 0; slot < capacity; slot++)
+	{
+		if (name_slots[slot] < -1 || name_slots[slot] >= header->num_nodes)
+			return "inconsistent name index";
+		num_used_slots += name_slots[slot] != -1;
+	}
+	if (num_used_slots != num_nodes)
+		return "inconsistent name index";
+
+	if (header->flags & SNAPSHOT_EDGE_BITS)
+	{
+		// The bits of each row are exactly the successors of the node.
+		const uint64_t *edge_bits = (const uint64_t *)(base + header->sections[section_edge_bits][0]);
+		size_t num_words = bitset_num_words(num_nodes);
+		for (uint64_t node = 0; node < num_nodes; node++)
+		{
+			const uint64_t *row = edge_bits + node * num_words;
+			if (bitset_popcount(row, num_words) != out_offsets[node + 1] - out_offsets[node])
+				return "inconsistent edge bits";
+			for (uint64_t i = out_offsets[node]; i < out_offsets[node + 1]; i++)
+				if (!bitset_test(row, out_targets[i]))
+					return "inconsistent edge bits";
+		}
+	}
+
+	const int32_t *edge_entries = (const int32_t *)(base + header->sections[section_edge_entries][0]);
+	const uint64_t *edge_parameter_offsets = (const uint64_t *)(base + header->sections[section_edge_parameter_offsets][0]);
+	const int32_t *edge_parameters = (const int32_t *)(base + header->sections[section_edge_parameters][0]);
+	for (uint64_t entry = 0; entry < header->num_edge_entries; entry++)
+	{
+		uint64_t first = edge_parameter_offsets[entry];
+		uint64_t last = edge_parameter_offsets[entry + 1];
+		if (first >= last || last > header->num_edge_parameters || edge_entries[2 * entry] < 0 || edge_entries[2 * entry] >= header->num_nodes || edge_entries[2 * entry + 1] < 0 || edge_entries[2 * entry + 1] >= header->num_nodes)
+			return "inconsistent edge parameters";
+		for (uint64_t i = first; i < last; i++)
+			if ((uint64_t)edge_parameters[2 * i] >= header->num_atoms || (uint64_t)edge_parameters[2 * i + 1] >= header->num_atoms)
+				return "unknown atom";
+	}
+	return NULL;
+}
+
+bool snapshot_try_load(char *path, Graph *result)
+{
+	int descriptor = open(path, O_RDONLY);
+	if (descriptor == -1)
+	{
+		printf("file %s does not exist.\n", path);
+		return false;
+	}
+	struct stat status;
+	if (fstat(descriptor, &status) == -1 || (size_t)status.st_size < sizeof(snapshotHeader))
+	{
+		close(descriptor);
+		return snapshot_invalid(path, "too short");
+	}
+	size_t length = (size_t)status.st_size;
+	char *base = (char *)mmap(NULL, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	close(descriptor);
+	if (base == MAP_FAILED)
+		return snapshot_invalid(path, "cannot be mapped");
+
+	const snapshotHeader *header = (const snapshotHeader *)base;
+	if (memcmp(header->magic, SNAPSHOT_MAGIC, 8) != 0 || header->version != SNAPSHOT_VERSION)
+	{
+		munmap(base, length);
+		return snapshot_invalid(path, "unknown format or version");
+	}
+	uint64_t num_nodes = header->num_nodes < 0 ? 0 : (uint64_t)header->num_nodes;
+	// Each element of a section takes at least 4 bytes: larger counts are invalid, and smaller ones cannot make the sizes below overflow.
+	if (header->num_nodes < 0 || header->num_atoms > length || header->num_adjacent > length || header->num_node_parameters > length || header->num_edge_entries > length || header->num_edge_parameters > length || header->name_slots_capacity > length ||
+		((header->flags & SNAPSHOT_EDGE_BITS) && num_nodes * bitset_num_words(num_nodes) > length))
+	{
+		munmap(base, length);
+		return snapshot_invalid(path, "inconsistent counts");
+	}
+	uint64_t expected[num_sections] = {
+		header->sections[section_strings][1],
+		num_nodes * sizeof(uint64_t),
+		header->num_atoms * sizeof(uint64_t),
+		(num_nodes + 1) * sizeof(uint64_t),
+		header->num_adjacent * sizeof(int32_t),
+		(num_nodes + 1) * sizeof(uint64_t),
+		header->num_adjacent * sizeof(int32_t),
+		(num_nodes + 1) * sizeof(uint64_t),
+		2 * header->num_node_parameters * sizeof(int32_t),
+		2 * header->num_edge_entries * sizeof(int32_t),
+		(header->num_edge_entries + 1) * sizeof(uint64_t),
+		2 * header->num_edge_parameters * sizeof(int32_t),
+		(header->flags & SNAPSHOT_NODE_ACTIONS) ? num_nodes * sizeof(int32_t) : 0,
+		header->name_slots_capacity * sizeof(int32_t),
+		(header->flags & SNAPSHOT_EDGE_BITS) ? num_nodes * bitset_num_words(num_nodes) * sizeof(uint64_t) : 0};
+	for (int section = 0; section < num_sections; section++)
+	{
+		uint64_t offset = header->sections[section][0];
+		if (offset % 8 != 0 || header->sections[section][1] != expected[section] || offset > length || expected[section] > length - offset)
+		{
+			munmap(base, length);
+			return snapshot_invalid(path, "truncated or inconsistent sections");
+		}
+	}
+	const char *strings = base + header->sections[section_strings][0];
+	uint64_t strings_size = header->sections[section_strings][1];
+	char *reason = strings_size == 0 ? (header->name != UINT64_MAX ? "unterminated strings" : NULL) : (strings[strings_size - 1] != '\0' ? "unterminated strings" : NULL);
+	if (reason == NULL)
+		reason = snapshot_check_sections(base, header, strings_size);
+	if (reason != NULL)
+	{
+		munmap(base, length);
+		return snapshot_invalid(path, reason);
+	}
+
+	Graph graph;
+	graph.structure_arena = arena_create();
+	snapshotMapping *mapping = (snapshotMapping *)arena_alloc(graph.structure_arena, sizeof(snapshotMapping));
+	mapping->address = base;
+	mapping->length = length;
+	arena_add_cleanup(graph.structure_arena, snapshot_unmap, mapping);
+	graph.parameters_arena = arena_create();
+	graph.source_arena = NULL;
+	graph.edge_parameters.capacity = 0;
+	graph.edge_parameters.size = 0;
+	graph.edge_parameters.slots = NULL;
+	graph.edge_parameters.arena = arena_create();
+
+	// The structure is used in place: the mapping is read-only, and the graph never modifies it (copies modifying it get their own).
+	graph.numNodes = header->num_nodes;
+	graph.numEdges = header->num_edges;
+	graph.name = header->name == UINT64_MAX || header->name >= strings_size ? NULL : (char *)strings + header->name;
+	const uint64_t *node_names = (const uint64_t *)(base + header->sections[section_node_names][0]);
+	graph.nodes = (char **)arena_alloc(graph.structure_arena, num_nodes * sizeof(char *));
+	for (int node = 0; node < graph.numNodes; node++)
+		graph.nodes[node] = (char *)strings + node_names[node];
+	graph.name_slots = (int *)(base + header->sections[section_name_slots][0]);
+	graph.name_slots_capacity = header->name_slots_capacity;
+	graph.out_offsets = (size_t *)(base + header->sections[section_out_offsets][0]);
+	graph.out_targets = (int *)(base + header->sections[section_out_targets][0]);
+	graph.in_offsets = (size_t *)(base + header->sections[section_in_offsets][0]);
+	graph.in_sources = (int *)(base + header->sections[section_in_sources][0]);
+
+	// No matrix of edges: graph_is_edge reads the edge bits, or the sorted successors.
+	graph.edges = NULL;
+	graph.edge_bits = (header->flags & SNAPSHOT_EDGE_BITS) ? (uint64_t *)(base + header->sections[section_edge_bits][0]) : NULL;
+	graph.edge_bits_words = (header->flags & SNAPSHOT_EDGE_BITS) ? bitset_num_words(num_nodes) : 0;
+	graph.node_actions = (header->flags & SNAPSHOT_NODE_ACTIONS) ? (int *)(base + header->sections[section_node_actions][0]) : NULL;
+	graph.initial = header->initial;
+	graph.final = header->final;
+
+	// Atoms are global to the program: the strings of the snapshot are interned once each.
+	const uint64_t *atom_offsets = (const uint64_t *)(base + header->sections[section_atoms][0]);
+	atom *atoms = (atom *)malloc((header->num_atoms + 1) * sizeof(atom));
+	for (uint64_t i = 0; i < header->num_atoms; i++)
+		atoms[i] = atom_intern((char *)strings + atom_offsets[i]);
+
+	const uint64_t *node_parameter_offsets = (const uint64_t *)(base + header->sections[section_node_parameter_offsets][0]);
+	const int32_t *node_parameters = (const int32_t *)(base + header->sections[section_node_parameters][0]);
+	graph.parameters = (parameterList **)arena_alloc(graph.parameters_arena, num_nodes * sizeof(parameterList *));
+	graph.parameter_block = (parameterList *)arena_alloc(graph.parameters_arena, header->num_node_parameters * sizeof(parameterList));
+	for (int node = 0; node < graph.numNodes; node++)
+	{
+		uint64_t first = node_parameter_offsets[node];
+		uint64_t last = node_parameter_offsets[node + 1];
+		graph.parameters[node] = first == last ? NULL : &graph.parameter_block[first];
+		for (uint64_t i = first; i < last; i++)
+		{
+			parameterList *cell = &graph.parameter_block[i];
+			cell->name_atom = atoms[node_parameters[2 * i]];
+			cell->value_atom = atoms[node_parameters[2 * i + 1]];
+			cell->name = atom_string(cell->name_atom);
+			cell->value = atom_string(cell->value_atom);
+			cell->span = NULL;
+			cell->next = i + 1 == last ? NULL : cell + 1;
+		}
+	}
+
+	const int32_t *edge_entries = (const int32_t *)(base + header->sections[section_edge_entries][0]);
+	const uint64_t *edge_parameter_offsets = (const uint64_t *)(base + header->sections[section_edge_parameter_offsets][0]);
+	const int32_t *edge_parameters = (const int32_t *)(base + header->sections[section_edge_parameters][0]);
+	parameterList *cells = (parameterList *)malloc((header->num_edge_parameters + 1) * sizeof(parameterList));
+	for (uint64_t entry = 0; entry < header->num_edge_entries; entry++)
+	{
+		uint64_t first = edge_parameter_offsets[entry];
+		uint64_t last = edge_parameter_offsets[entry + 1];
+		for (uint64_t i = first; i < last; i++)
+		{
+			cells[i].name_atom = atoms[edge_parameters[2 * i]];
+			cells[i].value_atom = atoms[edge_parameters[2 * i + 1]];
+			cells[i].name = atom_string(cells[i].name_atom);
+			cells[i].value = atom_string(cells[i].value_atom);
+			cells[i].span = NULL;
+			cells[i].next = i + 1 == last ? NULL : &cells[i + 1];
+		}
+		graph_set_edge_parameter(&graph, edge_entries[2 * entry], edge_entries[2 * entry + 1], &cells[first]);
+	}
+	free(cells);
+	free(atoms);
+
+	*result = graph;
+	return true;
+}
+
+Graph snapshot_load(char *path)
+{
+	Graph graph;
+	if (!snapshot_try_load(path, &graph))
+	{
+		printf("Exiting.\n");
+		exit(-1);
+	}
+	return graph;
+}
@@ -1,8 +1,10 @@
 
 #include "Z3Tools.h"
+#include "Bitset.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 
 Z3_context make_context(void)
 {
@@ -24,63 +26,548 @@ Z3_ast mk_bool_var(Z3_context ctx, const char *name)
     return mk_var(ctx, name, ty);
 }
 
-int inner_at_most(Z3_context ctx, Z3_ast *formulae, int size, Z3_ast *result)
+/**
+ * @brief A family of variables of a table.
+ */
+typedef struct
 {
-    int count = 0;
-    for (int i = 0; i < size; i++)
+    variableNamer namer; ///< Writes the names of the variables.
+    int sizes[3];        ///< The number of values of each coordinate covered by ids (grown when a variable beyond them is created).
+    int *ids;            ///< The id of each variable, indexed by its coordinates (NO_VARIABLE if not created yet).
+} variableFamily;
+
+/**
+ * @brief The id of a variable not created yet.
+ */
+#define NO_VARIABLE (-1)
+
+/**
+ * @brief The family and the coordinates of a variable, given its id.
+ */
+typedef struct
+{
+    int family;         ///< The family of the variable.
+    int coordinates[3]; ///< Its coordinates.
+} variableCoordinates;
+
+struct VariableTable_s
+{
+    Z3_context ctx;                   ///< The context of the variables.
+    Z3_sort bool_sort;                ///< The sort of the variables.
+    variableFamily *families;         ///< The families.
+    int num_families;                 ///< Their number.
+    Z3_ast *variables;                ///< The variables created, by id.
+    variableCoordinates *coordinates; ///< The family and coordinates of each variable, by id.
+    int num_variables;                ///< The number of variables created, which are the ids from 0 to this number minus one.
+    int capacity;                     ///< The size of variables and coordinates.
+};
+
+VariableTable variable_table_create(Z3_context ctx)
+{
+    VariableTable table = (VariableTable)calloc(1, sizeof(struct VariableTable_s));
+    table->ctx = ctx;
+    table->bool_sort = Z3_mk_bool_sort(ctx);
+    return table;
+}
+
+int variable_table_add_family(VariableTable table, variableNamer namer, int size_1, int size_2, int size_3)
+{
+    table->families = (variableFamily *)realloc(table->families, (table->num_families + 1) * sizeof(variableFamily));
+    variableFamily *family = &table->families[table->num_families];
+    family->namer = namer;
+    family->sizes[0] = size_1;
+    family->sizes[1] = size_2;
+    family->sizes[2] = size_3;
+    size_t num_ids = (size_t)size_1 * size_2 * size_3;
+    family->ids = (int *)malloc(num_ids * sizeof(int));
+    for (size_t i = 0; i < num_ids; i++)
+        family->ids[i] = NO_VARIABLE;
+    return table->num_families++;
+}
+
+/**
+ * @brief Computes the position of a variable in the ids of its family.
+ *
+ * @param family The family of the variable.
+ * @param coordinate_1 Its first coordinate.
+ * @param coordinate_2 Its second coordinate.
+ * @param coordinate_3 Its third coordinate.
+ * @return size_t The position, or SIZE_MAX if the coordinates are beyond the sizes of @p family.
+ */
+static size_t variable_position(const variableFamily *family, int coordinate_1, int coordinate_2, int coordinate_3)
+{
+    if (coordinate_1 >= family->sizes[0] || coordinate_2 >= family->sizes[1] || coordinate_3 >= family->sizes[2])
+        return SIZE_MAX;
+    return ((size_t)coordinate_1 * family->sizes[1] + coordinate_2) * family->sizes[2] + coordinate_3;
+}
+
+/**
+ * @brief Grows the ids of a family so that they cover the coordinates given in argument (each size at least doubles when it grows). The ids already given are kept.
+ *
+ * @param family The family.
+ * @param coordinate_1 A first coordinate.
+ * @param coordinate_2 A second coordinate.
+ * @param coordinate_3 A third coordinate.
+ */
+static void variable_family_grow(variableFamily *family, int coordinate_1, int coordinate_2, int coordinate_3)
+{
+    int coordinates[3] = {coordinate_1, coordinate_2, coordinate_3};
+    int sizes[3];
+    for (int i = 0; i < 3; i++)
+    {
+        sizes[i] = family->sizes[i];
+        if (coordinates[i] >= sizes[i])
+            sizes[i] = coordinates[i] + 1 > 2 * sizes[i] ? coordinates[i] + 1 : 2 * sizes[i];
+    }
+    size_t num_ids = (size_t)sizes[0] * sizes[1] * sizes[2];
+    int *ids = (int *)malloc(num_ids * sizeof(int));
+    for (size_t i = 0; i < num_ids; i++)
+        ids[i] = NO_VARIABLE;
+    for (int coordinate_1 = 0; coordinate_1 < family->sizes[0]; coordinate_1++)
+        for (int coordinate_2 = 0; coordinate_2 < family->sizes[1]; coordinate_2++)
+            memcpy(ids + ((size_t)coordinate_1 * sizes[1] + coordinate_2) * sizes[2],
+                   family->ids + ((size_t)coordinate_1 * family->sizes[1] + coordinate_2) * family->sizes[2], family->sizes[2] * sizeof(int));
+    free(family->ids);
+    family->ids = ids;
+    memcpy(family->sizes, sizes, sizeof(sizes));
+}
+
+Z3_ast variable_table_get(VariableTable table, int family, int coordinate_1, int coordinate_2, int coordinate_3)
+{
+    variableFamily *variables = &table->families[family];
+    size_t position = variable_position(variables, coordinate_1, coordinate_2, coordinate_3);
+    if (position == SIZE_MAX)
+    {
+        variable_family_grow(variables, coordinate_1, coordinate_2, coordinate_3);
+        position = variable_position(variables, coordinate_1, coordinate_2, coordinate_3);
+    }
+    int id = variables->ids[position];
+    if (id != NO_VARIABLE)
+        return table->variables[id];
+
+    // The variable gets the next id, whatever its family and coordinates.
+    if (table->num_variables == table->capacity)
+    {
+        table->capacity = table->capacity == 0 ? 1024 : 2 * table->capacity;
+        table->variables = (Z3_ast *)realloc(table->variables, table->capacity * sizeof(Z3_ast));
+        table->coordinates = (variableCoordinates *)realloc(table->coordinates, table->capacity * sizeof(variableCoordinates));
+    }
+    id = table->num_variables++;
+    variables->ids[position] = id;
+    table->variables[id] = Z3_mk_const(table->ctx, Z3_mk_int_symbol(table->ctx, id), table->bool_sort);
+    table->coordinates[id] = (variableCoordinates){family, {coordinate_1, coordinate_2, coordinate_3}};
+    return table->variables[id];
+}
+
+uint64_t *variable_table_model_values(const VariableTable table, Z3_model model)
+{
+    Z3_context ctx = table->ctx;
+    uint64_t *values = bitset_create(table->num_variables);
+    unsigned num_constants = Z3_model_get_num_consts(ctx, model);
+    for (unsigned i = 0; i < num_constants; i++)
+    {
+        Z3_func_decl constant = Z3_model_get_const_decl(ctx, model, i);
+        Z3_symbol symbol = Z3_get_decl_name(ctx, constant);
+        // The auxiliary variables of the encodings have string symbols.
+        if (Z3_get_symbol_kind(ctx, symbol) != Z3_INT_SYMBOL)
+            continue;
+        int id = Z3_get_symbol_int(ctx, symbol);
+        if (id >= table->num_variables)
+            continue;
+        Z3_ast value = Z3_model_get_const_interp(ctx, model, constant);
+        if (value != NULL && Z3_get_bool_value(ctx, value) == Z3_L_TRUE)
+            bitset_set(values, id);
+    }
+    return values;
+}
+
+bool variable_table_value(const VariableTable table, const uint64_t *values, int family, int coordinate_1, int coordinate_2, int coordinate_3)
+{
+    const variableFamily *variables = &table->families[family];
+    size_t position = variable_position(variables, coordinate_1, coordinate_2, coordinate_3);
+    // A variable not created yet is in no formula, so is false as with value_of_var_in_model.
+    if (position == SIZE_MAX || variables->ids[position] == NO_VARIABLE)
+        return false;
+    return bitset_test(values, variables->ids[position]);
+}
+
+Z3_ast variable_table_readable(VariableTable table, Z3_ast formula)
+{
+    Z3_ast *named = (Z3_ast *)malloc(table->num_variables * sizeof(Z3_ast));
+    for (int id = 0; id < table->num_variables; id++)
+    {
+        const variableCoordinates *variable = &table->coordinates[id];
+        char name[80];
+        table->families[variable->family].namer(name, sizeof(name), variable->coordinates[0], variable->coordinates[1], variable->coordinates[2]);
+        named[id] = mk_bool_var(table->ctx, name);
+    }
+    Z3_ast result = Z3_substitute(table->ctx, formula, table->num_variables, table->variables, named);
+    free(named);
+    return result;
+}
+
+void variable_table_delete(VariableTable table)
+{
+    for (int family = 0; family < table->num_families; family++)
+        free(table->families[family].ids);
+    free(table->families);
+    free(table->variables);
+    free(table->coordinates);
+    free(table);
+}
+
+/**
+ * @brief Formulae with at most this many operands are constrained pairwise by the automatic choice of encoding.
+ */
+#define AT_MOST_ONE_PAIRWISE_MAX 6
+
+/**
+ * @brief Formulae with at most this many operands (and more than AT_MOST_ONE_PAIRWISE_MAX) are constrained by a sequential counter by the automatic choice of encoding, larger ones with commanders.
+ */
+#define AT_MOST_ONE_SEQUENTIAL_MAX 4096
+
+/**
+ * @brief The size of the groups of the commander encoding.
+ */
+#define COMMANDER_GROUP_SIZE 3
+
+/**
+ * @brief The encoding used by at_most_formula and uniqueFormula (see set_at_most_one_encoding).
+ */
+static atMostOneEncoding at_most_one_encoding = at_most_one_auto;
+
+void set_at_most_one_encoding(atMostOneEncoding encoding)
+{
+    at_most_one_encoding = encoding;
+}
+
+bool at_most_one_encoding_from_name(const char *name, atMostOneEncoding *encoding)
+{
+    static const char *names[] = {"auto", "pairwise", "sequential", "commander", "bimander", "native"};
+    for (int i = 0; i < (int)(sizeof(names) / sizeof(names[0])); i++)
+        if (strcmp(name, names[i]) == 0)
+        {
+            *encoding = (atMostOneEncoding)i;
+            return true;
+        }
+    return false;
+}
+
+/**
+ * @brief A growing array of clauses, whose conjunction is built at the end.
+ */
+typedef struct
+{
+    Z3_ast *clauses; ///< The clauses.
+    int size;        ///< Their number.
+    int capacity;    ///< The number of clauses allocated.
+} clauseList;
+
+/**
+ * @brief Adds a clause to a list.
+ *
+ * @param list The list.
+ * @param clause The clause.
+ */
+static void clause_list_push(clauseList *list, Z3_ast clause)
+{
+    if (list->size == list->capacity)
     {
+        list->capacity = list->capacity == 0 ? 16 : 2 * list->capacity;
+        list->clauses = (Z3_ast *)realloc(list->clauses, list->capacity * sizeof(Z3_ast));
+    }
+    list->clauses[list->size++] = clause;
+}
+
+/**
+ * @brief Adds the clause @p first ∨ @p second to a list.
+ *
+ * @param ctx The solver context.
+ * @param list The list.
+ * @param first A literal.
+ * @param second A literal.
+ */
+static void clause_list_add(Z3_context ctx, clauseList *list, Z3_ast first, Z3_ast second)
+{
+    Z3_ast literals[2] = {first, second};
+    clause_list_push(list, Z3_mk_or(ctx, 2, literals));
+}
+
+/**
+ * @brief Creates an auxiliary variable of an encoding, distinct from every other variable.
+ *
+ * @param ctx The solver context.
+ * @return Z3_ast The variable.
+ */
+static Z3_ast mk_auxiliary_var(Z3_context ctx)
+{
+    return Z3_mk_fresh_const(ctx, "amo", Z3_mk_bool_sort(ctx));
+}
+
+/**
+ * @brief Pairwise encoding: ¬x_i ∨ ¬x_j for each pair i < j.
+ *
+ * @param ctx The solver context.
+ * @param formulae The formulae.
+ * @param size The number of formulae.
+ * @param clauses The list where the clauses are added.
+ */
+static void pairwise_at_most(Z3_context ctx, Z3_ast *formulae, int size, clauseList *clauses)
+{
+    for (int i = 0; i < size; i++)
         for (int j = i + 1; j < size; j++)
+            clause_list_add(ctx, clauses, Z3_mk_not(ctx, formulae[i]), Z3_mk_not(ctx, formulae[j]));
+}
+
+/**
+ * @brief Sequential counter encoding (Sinz 2005): s_i is true when one of x_1..x_i is, and x_i cannot be true when s_(i-1) is.
+ *
+ * @param ctx The solver context.
+ * @param formulae The formulae.
+ * @param size The number of formulae.
+ * @param clauses The list where the clauses are added.
+ */
+static void sequential_at_most(Z3_context ctx, Z3_ast *formulae, int size, clauseList *clauses)
+{
+    if (size < 2)
+        return;
+    Z3_ast previous = mk_auxiliary_var(ctx);
+    clause_list_add(ctx, clauses, Z3_mk_not(ctx, formulae[0]), previous);
+    for (int i = 1; i < size - 1; i++)
+    {
+        Z3_ast counter = mk_auxiliary_var(ctx);
+        Z3_ast not_formula = Z3_mk_not(ctx, formulae[i]);
+        clause_list_add(ctx, clauses, not_formula, counter);
+        clause_list_add(ctx, clauses, Z3_mk_not(ctx, previous), counter);
+        clause_list_add(ctx, clauses, not_formula, Z3_mk_not(ctx, previous));
+        previous = counter;
+    }
+    clause_list_add(ctx, clauses, Z3_mk_not(ctx, formulae[size - 1]), Z3_mk_not(ctx, previous));
+}
+
+/**
+ * @brief Commander encoding (Klieber and Kwon 2007): the formulae are split in groups of COMMANDER_GROUP_SIZE, each constrained pairwise, whose commander is true exactly when one of the group is.
+ *        At most one commander is true, recursively.
+ *
+ * @param ctx The solver context.
+ * @param formulae The formulae.
+ * @param size The number of formulae.
+ * @param clauses The list where the clauses are added.
+ */
+static void commander_at_most(Z3_context ctx, Z3_ast *formulae, int size, clauseList *clauses)
+{
+    if (size <= COMMANDER_GROUP_SIZE)
+    {
+        pairwise_at_most(ctx, formulae, size, clauses);
+        return;
+    }
+    int num_groups = (size + COMMANDER_GROUP_SIZE - 1) / COMMANDER_GROUP_SIZE;
+    Z3_ast *commanders = (Z3_ast *)malloc(num_groups * sizeof(Z3_ast));
+    for (int group = 0; group < num_groups; group++)
+    {
+        Z3_ast *members = formulae + group * COMMANDER_GROUP_SIZE;
+        int num_members = size - group * COMMANDER_GROUP_SIZE;
+        if (num_members > COMMANDER_GROUP_SIZE)
+            num_members = COMMANDER_GROUP_SIZE;
+        commanders[group] = mk_auxiliary_var(ctx);
+        pairwise_at_most(ctx, members, num_members, clauses);
+        for (int member = 0; member < num_members; member++)
+            clause_list_add(ctx, clauses, Z3_mk_not(ctx, members[member]), commanders[group]);
+        // Not needed for correctness, but makes the commander equivalent to its group, which helps propagation.
+        Z3_ast group_literals[COMMANDER_GROUP_SIZE + 1];
+        group_literals[0] = Z3_mk_not(ctx, commanders[group]);
+        for (int member = 0; member < num_members; member++)
+            group_literals[member + 1] = members[member];
+        clause_list_push(clauses, Z3_mk_or(ctx, num_members + 1, group_literals));
+    }
+    commander_at_most(ctx, commanders, num_groups, clauses);
+    free(commanders);
+}
+
+/**
+ * @brief Bimander encoding (Nguyen and Mai 2015): the formulae are split in pairs, constrained pairwise, and each true formula sets log2(number of pairs) auxiliary bits to the number of its pair.
+ *
+ * @param ctx The solver context.
+ * @param formulae The formulae.
+ * @param size The number of formulae.
+ * @param clauses The list where the clauses are added.
+ */
+static void bimander_at_most(Z3_context ctx, Z3_ast *formulae, int size, clauseList *clauses)
+{
+    int num_groups = (size + 1) / 2;
+    int num_bits = 0;
+    while ((1 << num_bits) < num_groups)
+        num_bits++;
+    Z3_ast bits[num_bits > 0 ? num_bits : 1];
+    for (int bit = 0; bit < num_bits; bit++)
+        bits[bit] = mk_auxiliary_var(ctx);
+    for (int group = 0; group < num_groups; group++)
+    {
+        int num_members = size - 2 * group < 2 ? 1 : 2;
+        pairwise_at_most(ctx, formulae + 2 * group, num_members, clauses);
+        for (int member = 0; member < num_members; member++)
         {
-            Z3_ast subFor[2];
-            subFor[0] = Z3_mk_not(ctx, formulae[i]);
-            subFor[1] = Z3_mk_not(ctx, formulae[j]);
-            result[count] = Z3_mk_or(ctx, 2, subFor);
-            count++;
+            Z3_ast not_formula = Z3_mk_not(ctx, formulae[2 * group + member]);
+            for (int bit = 0; bit < num_bits; bit++)
+                clause_list_add(ctx, clauses, not_formula, (group >> bit) & 1 ? bits[bit] : Z3_mk_not(ctx, bits[bit]));
         }
     }
-    return count;
+}
+
+/**
+ * @brief Adds the clauses stating that at most one of @p formulae is true, with the current encoding.
+ *
+ * @param ctx The solver context.
+ * @param formulae The formulae.
+ * @param size The number of formulae.
+ * @param clauses The list where the clauses are added.
+ */
+static void inner_at_most(Z3_context ctx, Z3_ast *formulae, int size, clauseList *clauses)
+{
+    atMostOneEncoding encoding = at_most_one_encoding;
+    if (encoding == at_most_one_auto)
+        encoding = size <= AT_MOST_ONE_PAIRWISE_MAX     ? at_most_one_pairwise
+                   : size <= AT_MOST_ONE_SEQUENTIAL_MAX ? at_most_one_sequential
+                                                        : at_most_one_commander;
+    switch (encoding)
+    {
+    case at_most_one_sequential:
+        sequential_at_most(ctx, formulae, size, clauses);
+        break;
+    case at_most_one_commander:
+        commander_at_most(ctx, formulae, size, clauses);
+        break;
+    case at_most_one_bimander:
+        bimander_at_most(ctx, formulae, size, clauses);
+        break;
+    default:
+        pairwise_at_most(ctx, formulae, size, clauses);
+        break;
+    }
 }
 
 Z3_ast at_most_formula(Z3_context ctx, Z3_ast *formulae, int size)
 {
-    Z3_ast result[size * size];
-    int count = inner_at_most(ctx, formulae, size, result);
-    return Z3_mk_and(ctx, count, result);
+    if (at_most_one_encoding == at_most_one_native)
+        return Z3_mk_atmost(ctx, size, formulae, 1);
+    clauseList clauses = {NULL, 0, 0};
+    inner_at_most(ctx, formulae, size, &clauses);
+    Z3_ast result = Z3_mk_and(ctx, clauses.size, clauses.clauses);
+    free(clauses.clauses);
+    return result;
 }
 
 Z3_ast uniqueFormula(Z3_context ctx, Z3_ast *formulae, int size)
 {
-    Z3_ast result[size * size];
-    result[0] = Z3_mk_or(ctx, size, formulae);
-    int count = inner_at_most(ctx, formulae, size, result + 1);
-    return Z3_mk_and(ctx, count + 1, result);
+    if (at_most_one_encoding == at_most_one_native)
+    {
+        Z3_ast bounds[2] = {Z3_mk_atleast(ctx, size, formulae, 1), Z3_mk_atmost(ctx, size, formulae, 1)};
+        return Z3_mk_and(ctx, 2, bounds);
+    }
+    clauseList clauses = {NULL, 0, 0};
+    clause_list_push(&clauses, Z3_mk_or(ctx, size, formulae));
+    inner_at_most(ctx, formulae, size, &clauses);
+    Z3_ast result = Z3_mk_and(ctx, clauses.size, clauses.clauses);
+    free(clauses.clauses);
+    return result;
+}
+
+struct SolverSession_s
+{
+    Z3_context ctx;   ///< The context of the solver.
+    Z3_solver solver; ///< The solver.
+};
+
+SolverSession solver_session_create(Z3_context ctx)
+{
+    SolverSession session = (SolverSession)malloc(sizeof(struct SolverSession_s));
+    session->ctx = ctx;
+    session->solver = Z3_mk_solver(ctx);
+    Z3_solver_inc_ref(ctx, session->solver);
+    return session;
 }
 
-Z3_lbool is_formula_sat(Z3_context ctx, Z3_ast formula)
+void solver_session_add(SolverSession session, Z3_ast constraint)
+{
+    Z3_solver_assert(session->ctx, session->solver, constraint);
+}
+
+Z3_ast solver_session_add_retractable(SolverSession session, Z3_ast constraint)
+{
+    Z3_context ctx = session->ctx;
+    Z3_ast activation = Z3_mk_fresh_const(ctx, "activation", Z3_mk_bool_sort(ctx));
+    Z3_solver_assert(ctx, session->solver, Z3_mk_implies(ctx, activation, constraint));
+    return activation;
+}
+
+void solver_session_retract(SolverSession session, Z3_ast activation)
+{
+    Z3_solver_assert(session->ctx, session->solver, Z3_mk_not(session->ctx, activation));
+}
+
+void solver_session_push(SolverSession session)
+{
+    Z3_solver_push(session->ctx, session->solver);
+}
+
+void solver_session_pop(SolverSession session, int num_scopes)
 {
-    Z3_solver s = Z3_mk_solver(ctx);
-    Z3_solver_inc_ref(ctx, s);
-    Z3_solver_assert(ctx, s, formula);
+    Z3_solver_pop(session->ctx, session->solver, num_scopes);
+}
+
+Z3_lbool solver_session_check(SolverSession session, int num_assumptions, Z3_ast *assumptions)
+{
+    if (num_assumptions == 0)
+        return Z3_solver_check(session->ctx, session->solver);
+    return Z3_solver_check_assumptions(session->ctx, session->solver, num_assumptions, assumptions);
+}
 
-    Z3_lbool result = Z3_solver_check(ctx, s);
-    Z3_solver_dec_ref(ctx, s);
+Z3_model solver_session_get_model(SolverSession session)
+{
+    Z3_model model = Z3_solver_get_model(session->ctx, session->solver);
+    if (model)
+        Z3_model_inc_ref(session->ctx, model);
+    return model;
+}
+
+int solver_session_get_core(SolverSession session, Z3_ast *core)
+{
+    Z3_ast_vector vector = Z3_solver_get_unsat_core(session->ctx, session->solver);
+    Z3_ast_vector_inc_ref(session->ctx, vector);
+    int size = Z3_ast_vector_size(session->ctx, vector);
+    for (int i = 0; i < size; i++)
+        core[i] = Z3_ast_vector_get(session->ctx, vector, i);
+    Z3_ast_vector_dec_ref(session->ctx, vector);
+    return size;
+}
+
+void solver_session_delete(SolverSession session)
+{
+    Z3_solver_dec_ref(session->ctx, session->solver);
+    free(session);
+}
+
+Z3_lbool is_formula_sat(Z3_context ctx, Z3_ast formula)
+{
+    SolverSession session = solver_session_create(ctx);
+    solver_session_add(session, formula);
+    Z3_lbool result = solver_session_check(session, 0, NULL);
+    solver_session_delete(session);
     return result;
 }
 
 Z3_model get_model_from_sat_formula(Z3_context ctx, Z3_ast formula)
 {
-    Z3_solver s = Z3_mk_solver(ctx);
-    Z3_solver_inc_ref(ctx, s);
-    Z3_solver_assert(ctx, s, formula);
+    SolverSession session = solver_session_create(ctx);
+    solver_session_add(session, formula);
 
-    Z3_model m = 0;
-    Z3_lbool result = Z3_solver_check(ctx, s);
+    Z3_lbool result = solver_session_check(session, 0, NULL);
 
     switch (result)
     {
     case Z3_L_FALSE:
         fprintf(stderr, "Error: Trying to get a model from an unsat formula.\n");
-        Z3_solver_dec_ref(ctx, s);
+        solver_session_delete(session);
         exit(1);
     case Z3_L_UNDEF:
         printf("Warning: Getting a partial model from a formula of unknown satisfiability.\n");
@@ -89,20 +576,17 @@ Z3_model get_model_from_sat_formula(Z3_context ctx, Z3_ast formula)
         break;
     }
 
-    m = Z3_solver_get_model(ctx, s);
-    if (m)
-        Z3_model_inc_ref(ctx, m);
-    Z3_solver_dec_ref(ctx, s);
+    Z3_model m = solver_session_get_model(session);
+    solver_session_delete(session);
     return m;
 }
 
 Z3_lbool solve_formula(Z3_context ctx, Z3_ast formula, Z3_model *model)
 {
-    Z3_solver s = Z3_mk_solver(ctx);
-    Z3_solver_inc_ref(ctx, s);
-    Z3_solver_assert(ctx, s, formula);
+    SolverSession session = solver_session_create(ctx);
+    solver_session_add(session, formula);
 
-    Z3_lbool result = Z3_solver_check(ctx, s);
+    Z3_lbool result = solver_session_check(session, 0, NULL);
 
     switch (result)
     {
@@ -113,12 +597,10 @@ Z3_lbool solve_formula(Z3_context ctx, Z3_ast formula, Z3_model *model)
         printf("Warning: Getting a partial model from a formula of unknown satisfiability.\n");
         break;
     case Z3_L_TRUE:
-        *model = Z3_solver_get_model(ctx, s);
-        if (*model)
-            Z3_model_inc_ref(ctx, *model);
+        *model = solver_session_get_model(session);
     }
 
-    Z3_solver_dec_ref(ctx, s);
+    solver_session_delete(session);
     return result;
 }
 
@@ -13,6 +13,7 @@
 #include "Parsing.h"
 #include "Z3Tools.h"
 #include "Parser.h"
+#include "Snapshot.h"
 #ifdef REPARTITION
 #include "RepartitionGraph.h"
 #include "RepartitionResolution.h"
@@ -40,6 +41,7 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/resource.h>
 
 void usage()
 {
@@ -97,9 +99,36 @@ void usage()
 #endif
     printf(". Only active if -R is active. Writes it in a file in the folder 'sol' (see option -o)\n");
     printf(" -M         Displays the model of the satisfied formula, to help understanding why it is true, especially when there are variables not representing a part of the solution.\n");
+    printf(" -E ENC     Chooses the encoding of the \"at most one\" constraints of the reduction: \"pairwise\", \"sequential\", \"commander\", \"bimander\", \"native\" (cardinality constraints of Z3, without clauses) or \"auto\" [if not present: auto, which chooses by the number of formulae constrained].\n");
+    printf(" -N         Tunnel: searches the paths of increasing sizes with one incremental solver, that keeps what it learned from the smaller sizes [if not present: a new solver for each size].\n");
     printf(" -t         Displays the solution found [if not present, only displays the existence of the solution].\n");
     printf(" -f         Writes the result with colors in a .dot file. See next option for the name. These files will be produced in the folder 'sol'.\n");
     printf(" -o NAME    Writes the output graph in \"NAME_Brute.dot\" or \"NAME_SAT.dot\" depending of the algorithm used and the formula in \"NAME.formula\". [if not present: \"default_SAT.dot\", \"default_Brute.dot\" and \"default.formula\"]\n");
+    printf(" -W FILE    Writes the first input in binary snapshot format in FILE");
+#ifdef TUNNEL
+    printf(", with the actions of its nodes as a Tunnel Network");
+#endif
+    printf(". Snapshots can be given as inputs instead of dot files, and load without parsing.\n");
+    printf(" -j NUM     Loads the input files on NUM threads [if not present: the number of processors].\n");
+    printf(" -L         Keeps the attributes of the input files unparsed until they are read, so that the attributes the problem does not use take no memory (the files stay mapped in memory).\n");
+    printf(" -I         Reads the inputs as streams of concatenated graphs (the standard input if no file is given), and solves the problem on each graph as soon as it is read, while the next ones are parsed. The outputs of the n-th graph are named \"NAME_n\" (see option -o).\n");
+    printf(" -S stats   Reports the memory used by the inputs and the structures built from them, and the peak memory of the program after each phase (parse, build, encode, solve).\n");
+}
+
+/**
+ * @brief Displays the peak resident memory of the program, after @p phase.
+ *
+ * @param phase The name of the phase that just ended.
+ * @param size The size of the problem in this phase (not displayed if negative).
+ */
+void print_peak_memory(char *phase, int size)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    if (size < 0)
+        printf("[stats] peak resident memory after %s: %ld kB\n", phase, usage.ru_maxrss);
+    else
+        printf("[stats] peak resident memory after %s (size %d): %ld kB\n", phase, size, usage.ru_maxrss);
 }
 
 enum problemType
@@ -110,100 +139,50 @@ enum problemType
     Tunnel
 };
 
-int main(int argc, char *argv[])
+/**
+ * @brief The options of the program deciding what is solved and displayed.
+ */
+typedef struct
 {
-    if (argc < 2)
-    {
-        usage();
-        return 0;
-    }
-
-    enum problemType problem = Tunnel;
-    bool verbose = false;
-    bool displayTerminal = false;
-    bool outputFile = false;
-    bool printformula = false;
-    bool bruteForce = false;
-    bool reduction = false;
-    bool printModel = false;
-    char *problem_parameter = "";
-    char *solutionName = "default";
-    /*char *realArgs[argc];
-    int numArgs = 0;*/
-
-    int option;
+    enum problemType problem; ///< The problem solved.
+    bool verbose;             ///< Displays the structures built from the inputs.
+    bool displayTerminal;     ///< Displays the solution found.
+    bool outputFile;          ///< Writes the solution in a .dot file.
+    bool printformula;        ///< Writes the formula of the reduction in a file.
+    bool bruteForce;          ///< Solves the problem with the brute force algorithm.
+    bool reduction;           ///< Solves the problem with a reduction to SAT.
+    bool printModel;          ///< Displays the model of the formula.
+    char *problem_parameter;  ///< The value associated with the problem.
+    char *solutionName;       ///< The prefix of the files written.
+    bool stats;               ///< Reports the memory used.
+    bool incremental;         ///< Searches the paths of increasing sizes with one solver, that keeps what it learned.
+} solverOptions;
 
-    while ((option = getopt(argc, argv, ":hP:c:vFBGRMtfo:")) != -1)
-    {
-        switch (option)
-        {
-        case 'h':
-            usage();
-            return EXIT_SUCCESS;
-        case 'P':
-        {
-            char *pb = optarg;
-            if (strcmp(pb, "Colouring") == 0)
-                problem = Colouring;
-            if (strcmp(pb, "Repartition") == 0)
-                problem = Repartition;
-            if (strcmp(pb, "BoundedDeadlockChecking") == 0)
-                problem = LockChecking;
-            if (strcmp(pb, "Tunnel") == 0)
-                problem = Tunnel;
-        }
-        break;
-        case 'c':
-            problem_parameter = optarg;
-            break;
-        case 'v':
-            verbose = true;
-            break;
-        case 'B':
-            bruteForce = true;
-            break;
-        case 'R':
-            reduction = true;
-            break;
-        case 'F':
-            // printf("Don't insist, I'm not showing you the solution of the assignment yet!\n");
-            printformula = true;
-            break;
-        case 'M':
-            printModel = true;
-            break;
-        case 't':
-            displayTerminal = true;
-            break;
-        case 'f':
-            outputFile = true;
-            break;
-        case 'o':
-            solutionName = optarg;
-            break;
-        case '?':
-            printf("unknown option: %c\n", optopt);
-            break;
-        }
-    }
-
-    if (argc - optind < 1)
-    {
-        printf("No argument given. Exiting.\n");
-        return 0;
-    }
-
-    int num_graphs = argc - optind;
-    Graph graphs[argc - optind];
-    for (int i = optind; i < argc; i++)
-    {
-        graphs[i - optind] = get_graph_from_file(argv[i]);
-        // graph_print(graphs[i - optind]);
-        // printf("\nA\n");
-    }
+/**
+ * @brief Solves the problem selected in @p options on some input graphs, and displays the result.
+ *
+ * @param graphs The input graphs (only the first one is used, except for deadlock checking).
+ * @param num_graphs The number of input graphs.
+ * @param options The options of the program.
+ */
+void solve(Graph *graphs, int num_graphs, solverOptions *options)
+{
+    enum problemType problem = options->problem;
+    bool verbose = options->verbose;
+    bool displayTerminal = options->displayTerminal;
+    bool outputFile = options->outputFile;
+    bool printformula = options->printformula;
+    bool bruteForce = options->bruteForce;
+    bool reduction = options->reduction;
+    bool printModel = options->printModel;
+    char *problem_parameter = options->problem_parameter;
+    char *solutionName = options->solutionName;
+    bool stats = options->stats;
+    bool incremental = options->incremental;
 
     Graph graph = graphs[0];
 
+
 #ifdef REPARTITION
     if (problem == Repartition)
     {
@@ -339,6 +318,12 @@ int main(int argc, char *argv[])
 
         ColouredGraph coloured_graph = cg_initialize(graph);
 
+        if (stats)
+        {
+            print_peak_memory("build", -1);
+            printf("ColouredGraph: %zu bytes\n", cg_memory_usage(coloured_graph));
+        }
+
         if (verbose)
             cg_print(coloured_graph);
 
@@ -349,6 +334,11 @@ int main(int argc, char *argv[])
             bool res = colouring_brute_force(coloured_graph, num_colours);
             double end = (double)(clock() - start) / CLOCKS_PER_SEC;
             printf("Brute force computed the solution in %g seconds:\n", end);
+            if (stats)
+            {
+                print_peak_memory("solve (brute force)", num_colours);
+                printf("ColouredGraph: %zu bytes\n", cg_memory_usage(coloured_graph));
+            }
             if (res)
             {
                 printf("There is a %d-colouring of this graph.\n", num_colours);
@@ -372,15 +362,18 @@ int main(int argc, char *argv[])
             printf("\n************************\n*** Reduction to SAT ***\n************************\n\n");
 
             Z3_context ctx = make_context();
+            VariableTable variables = colouring_variable_table_create(ctx, coloured_graph);
 
             clock_t start = clock();
 
             Z3_ast formula;
-            formula = colouring_reduction(ctx, coloured_graph, num_colours);
+            formula = colouring_reduction(ctx, variables, coloured_graph, num_colours);
 
             clock_t timeFormula = clock();
 
             printf("formula computed in %g seconds\n", (double)(timeFormula - start) / CLOCKS_PER_SEC);
+            if (stats)
+                print_peak_memory("encode", num_colours);
 
             if (printformula)
             {
@@ -391,7 +384,7 @@ int main(int argc, char *argv[])
                 char nameFile[length];
                 snprintf(nameFile, length, "sol/%s.formula", solutionName);
                 FILE *file = fopen(nameFile, "w");
-                fprintf(file, "%s\n", Z3_ast_to_string(ctx, formula));
+                fprintf(file, "%s\n", Z3_ast_to_string(ctx, colouring_readable_formula(ctx, variables, formula)));
                 fclose(file);
                 printf("Formula printed in sol/%s.formula\n", solutionName);
             }
@@ -402,6 +395,8 @@ int main(int argc, char *argv[])
             clock_t timeSat = clock();
 
             printf("solution computed in %g seconds\n", (double)(timeSat - timeFormula) / CLOCKS_PER_SEC);
+            if (stats)
+                print_peak_memory("solve", num_colours);
 
             switch (isSat)
             {
@@ -417,7 +412,7 @@ int main(int argc, char *argv[])
                 printf("There is a %d-colouring of this graph.\n", num_colours);
 
                 if (displayTerminal || outputFile)
-                    colour_graph_from_model(ctx, model, coloured_graph, num_colours);
+                    colour_graph_from_model(ctx, variables, model, coloured_graph, num_colours);
 
                 //            if (displayModel)
                 //                printModel(ctx, model, biGraph, numComponent);
@@ -427,7 +422,7 @@ int main(int argc, char *argv[])
                     cg_print_colors(coloured_graph);
                 }
                 if (printModel)
-                    colouring_print_model(ctx, model, coloured_graph, num_colours);
+                    colouring_print_model(ctx, variables, model, coloured_graph, num_colours);
 
                 if (outputFile)
                 {
@@ -441,6 +436,7 @@ int main(int argc, char *argv[])
                 break;
             }
 
+            variable_table_delete(variables);
             Z3_del_context(ctx);
         }
 
@@ -591,6 +587,11 @@ int main(int argc, char *argv[])
     {
         printf("\n*****************************************\n*** Tunnel Network Problem ***\n*****************************************\n\n");
         TunnelNetwork network = tn_initialize(graph);
+        if (stats)
+        {
+            print_peak_memory("build", -1);
+            printf("TunnelNetwork: %zu bytes\n", tn_memory_usage(network));
+        }
         if (verbose)
         {
             tn_print(network);
@@ -640,6 +641,9 @@ int main(int argc, char *argv[])
             printf("\n************************\n*** Reduction to SAT ***\n************************\n\n");
 
             Z3_context ctx = make_context();
+            SolverSession session = incremental ? solver_session_create(ctx) : NULL;
+            // The formulae of all the sizes are built with one table, so that they share their variables.
+            VariableTable variables = tn_variable_table_create(ctx, network);
 
             for (int l = 1; l <= bound; l++)
             {
@@ -648,11 +652,13 @@ int main(int argc, char *argv[])
                 clock_t start = clock();
 
                 Z3_ast formula;
-                formula = tn_reduction(ctx, network, l);
+                formula = tn_reduction(ctx, variables, network, l);
 
                 clock_t timeFormula = clock();
 
                 printf("formula for size %d computed in %g seconds\n", l, (double)(timeFormula - start) / CLOCKS_PER_SEC);
+                if (stats)
+                    print_peak_memory("encode", l);
 
                 if (printformula)
                 {
@@ -664,7 +670,7 @@ int main(int argc, char *argv[])
                     char nameFile[length];
                     snprintf(nameFile, length, "sol/%s_%d.formula", solutionName, l);
                     FILE *file = fopen(nameFile, "w");
-                    fprintf(file, "%s\n", Z3_ast_to_string(ctx, formula));
+                    fprintf(file, "%s\n", Z3_ast_to_string(ctx, tn_readable_formula(ctx, variables, formula)));
                     fclose(file);
                     printf("Formula for size %d printed in sol/%s_%d.formula\n", l, solutionName, l);
 #else
@@ -673,11 +679,26 @@ int main(int argc, char *argv[])
                 }
 
                 Z3_model model;
-                Z3_lbool isSat = solve_formula(ctx, formula, &model);
+                Z3_lbool isSat;
+                if (incremental)
+                {
+                    // The formulae of the sizes share their variables: the formula of size l only holds under its activation literal, and is retracted once refuted,
+                    // while what the solver learned from the previous sizes stays.
+                    Z3_ast activation = solver_session_add_retractable(session, formula);
+                    isSat = solver_session_check(session, 1, &activation);
+                    if (isSat == Z3_L_TRUE)
+                        model = solver_session_get_model(session);
+                    else
+                        solver_session_retract(session, activation);
+                }
+                else
+                    isSat = solve_formula(ctx, formula, &model);
 
                 clock_t timeSat = clock();
 
                 printf("solution computed in %g seconds\n", (double)(timeSat - timeFormula) / CLOCKS_PER_SEC);
+                if (stats)
+                    print_peak_memory("solve", l);
 
                 switch (isSat)
                 {
@@ -695,14 +716,14 @@ int main(int argc, char *argv[])
                     if (!(displayTerminal || outputFile || printModel))
                         goto TN_end;
 
-                    tn_get_path_from_model(ctx, model, network, l, path);
+                    tn_get_path_from_model(ctx, variables, model, network, l, path);
 
                     if (displayTerminal)
                     {
                         tn_print_path(network, path, l);
                     }
                     if (printModel)
-                        tn_print_model(ctx, model, network, l);
+                        tn_print_model(ctx, variables, model, network, l);
 
                     if (outputFile)
                     {
@@ -718,12 +739,245 @@ int main(int argc, char *argv[])
             }
 
         TN_end:
+            if (session != NULL)
+                solver_session_delete(session);
+            variable_table_delete(variables);
             Z3_del_context(ctx);
         }
 
         tn_delete(network);
     }
 #endif
+}
+
+/**
+ * @brief Writes a graph in a binary snapshot.
+ *
+ * @param graph The graph (the actions of its nodes as a Tunnel Network are stored in it if this problem is available).
+ * @param snapshotName The name of the snapshot file.
+ */
+void write_snapshot(Graph *graph, char *snapshotName)
+{
+#ifdef TUNNEL
+    TunnelNetwork network = tn_initialize(*graph);
+    tn_store_node_actions(network, graph);
+    tn_delete(network);
+#endif
+    if (snapshot_write(*graph, snapshotName))
+        printf("Snapshot written in %s.\n", snapshotName);
+    else
+        printf("Could not write the snapshot %s.\n", snapshotName);
+}
+
+/**
+ * @brief Solves the problem on each graph of streams of concatenated graphs. Each graph is solved as soon as it is read, while the next ones are parsed.
+ *        The outputs of the n-th graph are named after the solution name followed by _n.
+ *
+ * @param files The names of the files containing the streams. The standard input is read if there are none.
+ * @param num_files The number of files.
+ * @param snapshotName If not NULL, the first graph is written in this snapshot.
+ * @param options The options of the program.
+ * @return int The exit status of the program.
+ */
+int solve_stream(char **files, int num_files, char *snapshotName, solverOptions *options)
+{
+    char *solutionName = options->solutionName;
+    int length = strlen(solutionName) + 12;
+    char graphName[length];
+    int num_graphs = 0;
+    int file = 0;
+    do
+    {
+        FILE *input = stdin;
+        if (num_files > 0)
+        {
+            input = fopen(files[file], "r");
+            if (input == NULL)
+            {
+                printf("file %s does not exist.\nExiting.\n", files[file]);
+                return -1;
+            }
+        }
+        graphStream *stream = graph_stream_open(input);
+        if (stream == NULL)
+        {
+            printf("Could not start reading the input.\nExiting.\n");
+            if (input != stdin)
+                fclose(input);
+            return -1;
+        }
+
+        Graph graph;
+        while (graph_stream_next(stream, &graph))
+        {
+            num_graphs++;
+            printf("\n=== Graph %d ===\n", num_graphs);
+            if (options->stats)
+            {
+                print_peak_memory("parse", -1);
+                graph_print_memory_usage(graph);
+                printf("Interned strings: %zu bytes\n", atom_memory_usage());
+            }
+            if (num_graphs == 1 && snapshotName != NULL)
+                write_snapshot(&graph, snapshotName);
+            snprintf(graphName, length, "%s_%d", solutionName, num_graphs);
+            options->solutionName = graphName;
+            solve(&graph, 1, options);
+            graph_delete(graph);
+        }
+
+        graph_stream_close(stream);
+        if (input != stdin)
+            fclose(input);
+    } while (++file < num_files);
+
+    options->solutionName = solutionName;
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        usage();
+        return 0;
+    }
+
+    enum problemType problem = Tunnel;
+    bool verbose = false;
+    bool displayTerminal = false;
+    bool outputFile = false;
+    bool printformula = false;
+    bool bruteForce = false;
+    bool reduction = false;
+    bool printModel = false;
+    char *problem_parameter = "";
+    char *solutionName = "default";
+    char *snapshotName = NULL;
+    bool stats = false;
+    bool incremental = false;
+    int num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    bool stream = false;
+    /*char *realArgs[argc];
+    int numArgs = 0;*/
+
+    int option;
+
+    while ((option = getopt(argc, argv, ":hP:c:vFBGRME:tfo:W:S:j:ILN")) != -1)
+    {
+        switch (option)
+        {
+        case 'h':
+            usage();
+            return EXIT_SUCCESS;
+        case 'P':
+        {
+            char *pb = optarg;
+            if (strcmp(pb, "Colouring") == 0)
+                problem = Colouring;
+            if (strcmp(pb, "Repartition") == 0)
+                problem = Repartition;
+            if (strcmp(pb, "BoundedDeadlockChecking") == 0)
+                problem = LockChecking;
+            if (strcmp(pb, "Tunnel") == 0)
+                problem = Tunnel;
+        }
+        break;
+        case 'c':
+            problem_parameter = optarg;
+            break;
+        case 'v':
+            verbose = true;
+            break;
+        case 'B':
+            bruteForce = true;
+            break;
+        case 'R':
+            reduction = true;
+            break;
+        case 'F':
+            // printf("Don't insist, I'm not showing you the solution of the assignment yet!\n");
+            printformula = true;
+            break;
+        case 'M':
+            printModel = true;
+            break;
+        case 'E':
+        {
+            atMostOneEncoding encoding;
+            if (at_most_one_encoding_from_name(optarg, &encoding))
+                set_at_most_one_encoding(encoding);
+            else
+                printf("unknown encoding: %s\n", optarg);
+        }
+        break;
+        case 't':
+            displayTerminal = true;
+            break;
+        case 'f':
+            outputFile = true;
+            break;
+        case 'o':
+            solutionName = optarg;
+            break;
+        case 'W':
+            snapshotName = optarg;
+            break;
+        case 'j':
+            num_threads = atoi(optarg);
+            break;
+        case 'I':
+            stream = true;
+            break;
+        case 'L':
+            set_lazy_attributes(true);
+            break;
+        case 'N':
+            incremental = true;
+            break;
+        case 'S':
+            if (strcmp(optarg, "stats") == 0)
+                stats = true;
+            else
+                printf("unknown report: %s\n", optarg);
+            break;
+        case '?':
+            printf("unknown option: %c\n", optopt);
+            break;
+        }
+    }
+
+    solverOptions options = {problem, verbose, displayTerminal, outputFile, printformula, bruteForce, reduction, printModel, problem_parameter, solutionName, stats, incremental};
+
+    if (stream)
+        return solve_stream(argv + optind, argc - optind, snapshotName, &options);
+
+    if (argc - optind < 1)
+    {
+        printf("No argument given. Exiting.\n");
+        return 0;
+    }
+
+    int num_graphs = argc - optind;
+    Graph graphs[argc - optind];
+    if (!get_graphs_from_files(argv + optind, num_graphs, graphs, num_threads < 1 ? 1 : num_threads))
+    {
+        printf("Exiting.\n");
+        return -1;
+    }
+
+    if (stats)
+    {
+        print_peak_memory("parse", -1);
+        for (int i = 0; i < num_graphs; i++)
+            graph_print_memory_usage(graphs[i]);
+        printf("Interned strings: %zu bytes\n", atom_memory_usage());
+    }
+
+    if (snapshotName != NULL)
+        write_snapshot(&graphs[0], snapshotName);
+
+    solve(graphs, num_graphs, &options);
 
     for (int i = 0; i < num_graphs; i++)
         graph_delete(graphs[i]);
@@ -480,8 +480,8 @@ static const flex_int16_t yy_chk[120] =
  * @file Lexer.l
  * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
  * @brief  Lexer for a graphviz parser, intended to serve for a master's project at University of Bordeaux. Adapted from gvizparse by Nikolaos Kavvadias (https://github.com/nkkav/gvizparse v1.0.0).
- * @version 1
- * @date 2019-07-24
+ * @version 2
+ * @date 2019-07-24, 2026-10-15
  * 
  * @copyright Creative Commons.
  * 
@@ -490,18 +490,41 @@ static const flex_int16_t yy_chk[120] =
 #include <ctype.h>
 #include <string.h>
 #include <stdlib.h>
-#include "GraphList.h"
+#include <setjmp.h>
+#include "GraphBuilder.h"
 #include "Parser.h"
 
- 
- #define MAXSIZE  1024
-char any_name_s[MAXSIZE];
+/* Fatal errors of the scanner abandon the parse instead of exiting the program. */
+#define YY_FATAL_ERROR(msg) lexer_fatal_error(msg, yyscanner)
+void lexer_fatal_error(const char *msg, yyscan_t yyscanner);
 
-#line 501 "src/parser/Lexer.c"
+/* The scanner reads its input through lexer_input, which decompresses compressed files. */
+#define YY_INPUT(buf, result, max_size) result = lexer_input(buf, max_size, yyscanner)
+int lexer_input(char *buffer, int max_size, yyscan_t yyscanner);
+
+/**
+ * @brief Returns a view of the current token. When the scanner reads a FILE, its buffer is refilled in place, so the token is copied in the arena of the scanner state.
+ *        Otherwise (mapped file or string), the view refers directly to the scanned buffer, which outlives the parse.
+ *
+ * @param text the text of the token.
+ * @param length its length.
+ * @param extra the scannerState of the scanner.
+ * @return tokenView the view of the token.
+ */
+static tokenView token_view(char *text, int length, void *extra)
+{
+    scannerState *state = (scannerState *)extra;
+    tokenView view;
+    view.start = state->tokens == NULL ? text : arena_strndup(state->tokens, text, length);
+    view.length = length;
+    return view;
+}
+
+#line 524 "src/parser/Lexer.c"
 /* %option outfile="Lexer.c" header-file="Lexer.h"  //for normal make.*/
 #define YY_NO_UNISTD_H 1
 #define YY_NO_INPUT 1
-#line 505 "src/parser/Lexer.c"
+#line 528 "src/parser/Lexer.c"
 
 #define INITIAL 0
 
@@ -773,9 +796,9 @@ YY_DECL
 		}
 
 	{
-#line 64 "src/parser/Lexer.l"
+#line 87 "src/parser/Lexer.l"
 
-#line 779 "src/parser/Lexer.c"
+#line 802 "src/parser/Lexer.c"
 
 	while ( /*CONSTCOND*/1 )		/* loops until end-of-file is reached */
 		{
@@ -830,132 +853,129 @@ do_action:	/* This label is used only to access EOF actions. */
 
 case 1:
 YY_RULE_SETUP
-#line 65 "src/parser/Lexer.l"
+#line 88 "src/parser/Lexer.l"
 { }
 	YY_BREAK
 case 2:
 /* rule 2 can match eol */
 YY_RULE_SETUP
-#line 66 "src/parser/Lexer.l"
-{ strcpy(any_name_s,yytext);
-                  yylval->name = any_name_s;
+#line 89 "src/parser/Lexer.l"
+{ yylval->view = token_view(yytext, yyleng, yyextra);
                   return(T_STRING); }
 	YY_BREAK
 case 3:
 /* rule 3 can match eol */
 YY_RULE_SETUP
-#line 69 "src/parser/Lexer.l"
+#line 91 "src/parser/Lexer.l"
 ;
 	YY_BREAK
 case 4:
 YY_RULE_SETUP
-#line 70 "src/parser/Lexer.l"
+#line 92 "src/parser/Lexer.l"
 { return(T_LBRACKET); }
 	YY_BREAK
 case 5:
 YY_RULE_SETUP
-#line 71 "src/parser/Lexer.l"
+#line 93 "src/parser/Lexer.l"
 { return(T_RBRACKET); }
 	YY_BREAK
 case 6:
 YY_RULE_SETUP
-#line 72 "src/parser/Lexer.l"
+#line 94 "src/parser/Lexer.l"
 { return(T_LPAREN); }
 	YY_BREAK
 case 7:
 YY_RULE_SETUP
-#line 73 "src/parser/Lexer.l"
+#line 95 "src/parser/Lexer.l"
 { return(T_RPAREN); }
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
-#line 74 "src/parser/Lexer.l"
+#line 96 "src/parser/Lexer.l"
 { return(T_LBRACE); }
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
-#line 75 "src/parser/Lexer.l"
+#line 97 "src/parser/Lexer.l"
 { return(T_RBRACE); }
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
-#line 76 "src/parser/Lexer.l"
+#line 98 "src/parser/Lexer.l"
 { return(T_COMMA); }
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
-#line 77 "src/parser/Lexer.l"
+#line 99 "src/parser/Lexer.l"
 { return(T_COLON); }
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
-#line 78 "src/parser/Lexer.l"
+#line 100 "src/parser/Lexer.l"
 { return(T_SEMI); }
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
-#line 79 "src/parser/Lexer.l"
+#line 101 "src/parser/Lexer.l"
 { return(T_DEDGE); }
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
-#line 80 "src/parser/Lexer.l"
+#line 102 "src/parser/Lexer.l"
 { return(T_UEDGE); }
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
-#line 81 "src/parser/Lexer.l"
+#line 103 "src/parser/Lexer.l"
 { return(T_EQ); }
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
-#line 82 "src/parser/Lexer.l"
+#line 104 "src/parser/Lexer.l"
 { return(T_DIGRAPH); }
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
-#line 83 "src/parser/Lexer.l"
+#line 105 "src/parser/Lexer.l"
 { return(T_GRAPH); }
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
-#line 84 "src/parser/Lexer.l"
+#line 106 "src/parser/Lexer.l"
 { return(T_SUBGRAPH); }
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
-#line 85 "src/parser/Lexer.l"
+#line 107 "src/parser/Lexer.l"
 { return(T_AT); }
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
-#line 86 "src/parser/Lexer.l"
+#line 108 "src/parser/Lexer.l"
 { return(T_STRICT); }
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
-#line 87 "src/parser/Lexer.l"
+#line 109 "src/parser/Lexer.l"
 { return(T_NODE); }
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
-#line 88 "src/parser/Lexer.l"
+#line 110 "src/parser/Lexer.l"
 { return(T_EDGE); }
 	YY_BREAK
 case 23:
 YY_RULE_SETUP
-#line 89 "src/parser/Lexer.l"
-{ //any_name_s = malloc(sizeof(yytext)+1);
-                  strcpy(any_name_s, yytext);
-                  yylval->name = any_name_s;
+#line 111 "src/parser/Lexer.l"
+{ yylval->view = token_view(yytext, yyleng, yyextra);
                   return(T_ID); }
 	YY_BREAK
 case 24:
 YY_RULE_SETUP
-#line 94 "src/parser/Lexer.l"
+#line 114 "src/parser/Lexer.l"
 ECHO;
 	YY_BREAK
-#line 959 "src/parser/Lexer.c"
+#line 979 "src/parser/Lexer.c"
 case YY_STATE_EOF(INITIAL):
 	yyterminate();
 
@@ -2099,8 +2119,39 @@ void yyfree (void * ptr , yyscan_t yyscanner)
 
 #define YYTABLES_NAME "yytables"
 
-#line 94 "src/parser/Lexer.l"
-
-
+#line 114 "src/parser/Lexer.l"
 
+/**
+ * @brief Reports a fatal error of the scanner, and abandons the parse by jumping to the point saved in the scanner state.
+ *
+ * @param msg the error.
+ * @param yyscanner the scanner.
+ */
+void lexer_fatal_error(const char *msg, yyscan_t yyscanner)
+{
+    scannerState *state = (scannerState *)yyget_extra(yyscanner);
+    if (state == NULL)
+        yy_fatal_error(msg, yyscanner);
+    printf("Erreur: %s\n", msg);
+    longjmp(state->on_error, 1);
+}
 
+/**
+ * @brief Fills the buffer of the scanner, from the decompressed input of the scanner state if any, and from the FILE of the scanner otherwise.
+ *
+ * @param buffer the buffer.
+ * @param max_size its size.
+ * @param yyscanner the scanner.
+ * @return int the number of characters read, 0 at the end of the input.
+ */
+int lexer_input(char *buffer, int max_size, yyscan_t yyscanner)
+{
+    scannerState *state = (scannerState *)yyget_extra(yyscanner);
+    if (state != NULL && state->input != NULL)
+        return compressed_input_read(state->input, buffer, max_size);
+    FILE *file = yyget_in(yyscanner);
+    size_t read = fread(buffer, 1, max_size, file);
+    if (read == 0 && ferror(file))
+        YY_FATAL_ERROR("input in flex scanner failed");
+    return read;
+}
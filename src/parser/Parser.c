@@ -73,7 +73,7 @@
  * @file Parser.l
  * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
  * @brief  Parser for a graphviz parser, intended to serve for a master's project at University of Bordeaux. Adapted from gvizparse by Nikolaos Kavvadias (https://github.com/nkkav/gvizparse v1.0.0).
- *         Convert a .dot file into a GraphList structure.
+ *         Convert a .dot file into a Graph, through a GraphBuilder.
            Does not support subgraphs for now.
            This version supports automata with custom syntax (nodes are declared initial (resp. final) with an option of the form "[initial=N]" (resp. "[final=N]"), with N standing for any string), and stores the color of the node (if any).
  * @version 2
@@ -83,12 +83,12 @@
  * 
  */
  
-#include "GraphList.h"
+#include "GraphBuilder.h"
 #include "Parser.h"
 #include "Lexer.h"
 #include "Graph.h"
 
-int yyerror(GraphList *expression, yyscan_t scanner, const char *msg) {
+int yyerror(GraphBuilder *builder, yyscan_t scanner, const char *msg) {
     /* Add error handling routine as needed */
     printf("Erreur: %s\n",msg);
     return 0;
@@ -556,12 +556,12 @@ static const yytype_int8 yytranslate[] =
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_uint8 yyrline[] =
 {
-       0,    91,    91,    94,    95,    98,    99,   102,   103,   106,
-     107,   109,   110,   113,   114,   115,   116,   117,   120,   121,
-     122,   125,   126,   127,   130,   133,   134,   137,   142,   147,
-     149,   153,   154,   160,   164,   170,   171,   172,   173,   176,
-     177,   180,   183,   187,   191,   192,   195,   198,   205,   206,
-     207,   210,   211
+       0,   101,   101,   104,   105,   108,   109,   112,   113,   116,
+     117,   119,   120,   123,   124,   125,   126,   127,   130,   131,
+     132,   135,   136,   137,   140,   143,   144,   147,   152,   156,
+     157,   160,   161,   166,   169,   174,   175,   176,   177,   180,
+     181,   184,   187,   190,   193,   194,   197,   200,   206,   207,
+     208,   211,   212
 };
 #endif
 
@@ -787,7 +787,7 @@ do {                                                                      \
 
 static void
 yy_symbol_value_print (FILE *yyo,
-                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, GraphList *graph, yyscan_t scanner)
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, GraphBuilder *graph, yyscan_t scanner)
 {
   FILE *yyoutput = yyo;
   YY_USE (yyoutput);
@@ -807,7 +807,7 @@ yy_symbol_value_print (FILE *yyo,
 
 static void
 yy_symbol_print (FILE *yyo,
-                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, GraphList *graph, yyscan_t scanner)
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, GraphBuilder *graph, yyscan_t scanner)
 {
   YYFPRINTF (yyo, "%s %s (",
              yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
@@ -846,7 +846,7 @@ do {                                                            \
 
 static void
 yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
-                 int yyrule, GraphList *graph, yyscan_t scanner)
+                 int yyrule, GraphBuilder *graph, yyscan_t scanner)
 {
   int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
@@ -908,7 +908,7 @@ int yydebug;
 
 static void
 yydestruct (const char *yymsg,
-            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, GraphList *graph, yyscan_t scanner)
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, GraphBuilder *graph, yyscan_t scanner)
 {
   YY_USE (yyvaluep);
   YY_USE (graph);
@@ -932,7 +932,7 @@ yydestruct (const char *yymsg,
 `----------*/
 
 int
-yyparse (GraphList *graph, yyscan_t scanner)
+yyparse (GraphBuilder *graph, yyscan_t scanner)
 {
 /* Lookahead token kind.  */
 int yychar;
@@ -1187,37 +1187,37 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* input: strict graph_type idrhs T_LBRACE stmt_list T_RBRACE  */
-#line 91 "src/parser/Parser.y"
-                                                            {graph->name = (yyvsp[-3].name);}
+#line 101 "src/parser/Parser.y"
+                                                            {graph_builder_set_name(graph,(yyvsp[-3].view).start,(yyvsp[-3].view).length);}
 #line 1193 "src/parser/Parser.c"
     break;
 
   case 5: /* graph_type: T_DIGRAPH  */
-#line 98 "src/parser/Parser.y"
+#line 108 "src/parser/Parser.y"
                         { graph->directed = true;}
 #line 1199 "src/parser/Parser.c"
     break;
 
   case 6: /* graph_type: T_GRAPH  */
-#line 99 "src/parser/Parser.y"
+#line 109 "src/parser/Parser.y"
                         { graph->directed = false;}
 #line 1205 "src/parser/Parser.c"
     break;
 
   case 21: /* attr_list: T_LBRACKET a_list T_RBRACKET  */
-#line 125 "src/parser/Parser.y"
+#line 135 "src/parser/Parser.y"
                                                 { (yyval.parameterInfo) = (yyvsp[-1].parameterInfo); }
 #line 1211 "src/parser/Parser.c"
     break;
 
   case 22: /* attr_list: T_LBRACKET T_RBRACKET  */
-#line 126 "src/parser/Parser.y"
+#line 136 "src/parser/Parser.y"
                                                 { (yyval.parameterInfo).parameters=NULL;}
 #line 1217 "src/parser/Parser.c"
     break;
 
   case 23: /* attr_list: T_LBRACKET a_list T_RBRACKET attr_list  */
-#line 127 "src/parser/Parser.y"
+#line 137 "src/parser/Parser.y"
                                                 { 
                                                 (yyval.parameterInfo).parameters = parameter_lists_merge((yyvsp[-2].parameterInfo).parameters,(yyvsp[0].parameterInfo).parameters);
                                                 }
@@ -1225,19 +1225,19 @@ yyreduce:
     break;
 
   case 24: /* attr_list: T_LBRACKET T_RBRACKET attr_list  */
-#line 130 "src/parser/Parser.y"
+#line 140 "src/parser/Parser.y"
                                                 { (yyval.parameterInfo) = (yyvsp[0].parameterInfo); }
 #line 1231 "src/parser/Parser.c"
     break;
 
   case 25: /* a_list: attr_assignment  */
-#line 133 "src/parser/Parser.y"
+#line 143 "src/parser/Parser.y"
                                         { (yyval.parameterInfo) = (yyvsp[0].parameterInfo);}
 #line 1237 "src/parser/Parser.c"
     break;
 
   case 26: /* a_list: attr_assignment T_COMMA a_list  */
-#line 134 "src/parser/Parser.y"
+#line 144 "src/parser/Parser.y"
                                         { 
                                             (yyval.parameterInfo).parameters = parameter_lists_merge((yyvsp[-2].parameterInfo).parameters,(yyvsp[0].parameterInfo).parameters);
                                           }
@@ -1245,7 +1245,7 @@ yyreduce:
     break;
 
   case 27: /* a_list: attr_assignment a_list  */
-#line 137 "src/parser/Parser.y"
+#line 147 "src/parser/Parser.y"
                                         { 
                                             (yyval.parameterInfo).parameters = parameter_lists_merge((yyvsp[-1].parameterInfo).parameters,(yyvsp[0].parameterInfo).parameters);
                                           }
@@ -1253,98 +1253,83 @@ yyreduce:
     break;
 
   case 28: /* attr_assignment: idrhs T_EQ idrhs  */
-#line 142 "src/parser/Parser.y"
+#line 152 "src/parser/Parser.y"
                                      { 
-      (yyval.parameterInfo).parameters = parameter_list_add_parameter(NULL,(yyvsp[-2].name),(yyvsp[0].name));
-             free((yyvsp[-2].name)); free((yyvsp[0].name));}
-#line 1261 "src/parser/Parser.c"
+      (yyval.parameterInfo).parameters = graph_builder_new_parameter(graph,(yyvsp[-2].view),(yyvsp[0].view));}
+#line 1260 "src/parser/Parser.c"
     break;
 
   case 29: /* idrhs: T_ID  */
-#line 147 "src/parser/Parser.y"
-                    { (yyval.name) = (char*)malloc((strlen((yyvsp[0].name))+1)*sizeof(char)); strcpy((yyval.name),(yyvsp[0].name));
-                    }
-#line 1268 "src/parser/Parser.c"
+#line 156 "src/parser/Parser.y"
+                    { (yyval.view) = (yyvsp[0].view); }
+#line 1266 "src/parser/Parser.c"
     break;
 
   case 30: /* idrhs: T_STRING  */
-#line 149 "src/parser/Parser.y"
-                    { (yyval.name) = (char*)malloc((strlen((yyvsp[0].name))+1)*sizeof(char)); strcpy((yyval.name),(yyvsp[0].name));
-                    }
-#line 1275 "src/parser/Parser.c"
-    break;
-
-  case 31: /* node_stmt: node_id  */
-#line 153 "src/parser/Parser.y"
-                            { free((yyvsp[0].name)); }
-#line 1281 "src/parser/Parser.c"
+#line 157 "src/parser/Parser.y"
+                    { (yyval.view) = (yyvsp[0].view); }
+#line 1272 "src/parser/Parser.c"
     break;
 
   case 32: /* node_stmt: node_id attr_list  */
-#line 154 "src/parser/Parser.y"
+#line 161 "src/parser/Parser.y"
                             {   
-                                add_parameters_to_node((yyvsp[-1].name),(yyvsp[0].parameterInfo).parameters,graph->nodes);
-                                free((yyvsp[-1].name));
+                                graph_builder_add_node_parameters(graph,(yyvsp[-1].node),(yyvsp[0].parameterInfo).parameters);
                             }
-#line 1290 "src/parser/Parser.c"
+#line 1280 "src/parser/Parser.c"
     break;
 
   case 33: /* node_id: T_ID  */
-#line 160 "src/parser/Parser.y"
+#line 166 "src/parser/Parser.y"
                     { 
-                      (yyval.name) = (char*)malloc((strlen((yyvsp[0].name))+1)*sizeof(char)); strcpy((yyval.name),(yyvsp[0].name));
-                      if(graph->nodes == NULL) graph->nodes = addNode((yyvsp[0].name),NULL); else addOrUpdateNode((yyvsp[0].name),graph->nodes);
+                      (yyval.node) = graph_builder_add_node(graph,(yyvsp[0].view).start,(yyvsp[0].view).length);
                     }
-#line 1299 "src/parser/Parser.c"
+#line 1288 "src/parser/Parser.c"
     break;
 
   case 34: /* node_id: T_ID port  */
-#line 164 "src/parser/Parser.y"
+#line 169 "src/parser/Parser.y"
                     { 
-                      (yyval.name) = (char*)malloc((strlen((yyvsp[-1].name))+1)*sizeof(char)); strcpy((yyval.name),(yyvsp[-1].name));
-                      if(graph->nodes == NULL) graph->nodes = addNode((yyvsp[-1].name),NULL); else addOrUpdateNode((yyvsp[-1].name),graph->nodes);
+                      (yyval.node) = graph_builder_add_node(graph,(yyvsp[-1].view).start,(yyvsp[-1].view).length);
                     }
-#line 1308 "src/parser/Parser.c"
+#line 1296 "src/parser/Parser.c"
     break;
 
   case 42: /* edge_stmt: node_id edgerhs  */
-#line 183 "src/parser/Parser.y"
-                                    { //printf("edge seen: (%s,%s)\n",$1,$2);
-                                      graph->edges = addEdge((yyvsp[-1].name),(yyvsp[0].name),graph->edges,NULL);
-                                      free((yyvsp[-1].name)); free((yyvsp[0].name));
+#line 187 "src/parser/Parser.y"
+                                    { //printf("edge seen: (%d,%d)\n",$1,$2);
+                                      graph_builder_add_edge(graph,(yyvsp[-1].node),(yyvsp[0].node),NULL);
                                     }
-#line 1317 "src/parser/Parser.c"
+#line 1304 "src/parser/Parser.c"
     break;
 
   case 43: /* edge_stmt: node_id edgerhs attr_list  */
-#line 187 "src/parser/Parser.y"
-                                    { //printf("edge seen: (%s,%s)\n",$1,$2);
-                                      graph->edges = addEdge((yyvsp[-2].name),(yyvsp[-1].name),graph->edges,(yyvsp[0].parameterInfo).parameters);
-                                      free((yyvsp[-2].name)); free((yyvsp[-1].name));
+#line 190 "src/parser/Parser.y"
+                                    { //printf("edge seen: (%d,%d)\n",$1,$2);
+                                      graph_builder_add_edge(graph,(yyvsp[-2].node),(yyvsp[-1].node),(yyvsp[0].parameterInfo).parameters);
                                     }
-#line 1326 "src/parser/Parser.c"
+#line 1312 "src/parser/Parser.c"
     break;
 
   case 46: /* edgerhs: edgeop node_id  */
-#line 195 "src/parser/Parser.y"
+#line 197 "src/parser/Parser.y"
                                 { //printf("edge end seen\n");
-                                  (yyval.name) = (yyvsp[0].name);
+                                  (yyval.node) = (yyvsp[0].node);
                                 }
-#line 1334 "src/parser/Parser.c"
+#line 1320 "src/parser/Parser.c"
     break;
 
   case 47: /* edgerhs: edgeop node_id edgerhs  */
-#line 198 "src/parser/Parser.y"
+#line 200 "src/parser/Parser.y"
                                 {
-                                  graph->edges = addEdge((yyvsp[-1].name),(yyvsp[0].name),graph->edges,NULL);
-                                  free((yyvsp[0].name));
-                                  (yyval.name) = (yyvsp[-1].name);
+                                  graph_builder_add_edge(graph,(yyvsp[-1].node),(yyvsp[0].node),NULL);
+                                  (yyval.node) = (yyvsp[-1].node);
                                 }
-#line 1344 "src/parser/Parser.c"
+#line 1329 "src/parser/Parser.c"
     break;
 
 
-#line 1348 "src/parser/Parser.c"
+#line 1333 "src/parser/Parser.c"
 
       default: break;
     }
@@ -1537,7 +1522,7 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 214 "src/parser/Parser.y"
+#line 215 "src/parser/Parser.y"
 
 
 #include <stdio.h>
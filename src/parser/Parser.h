@@ -47,12 +47,21 @@ extern int yydebug;
 /* "%code requires" blocks.  */
 #line 29 "src/parser/Parser.y"
 
+  #include <setjmp.h>
+  #include "GraphBuilder.h"
+  #include "CompressedInput.h"
   typedef void* yyscan_t;
+  /* The extra data of a scanner, so that several scanners can run at the same time. */
+  typedef struct {
+      Arena tokens;     /* The arena in which tokens are copied, or NULL if the scanned buffer outlives the parse. */
+      jmp_buf on_error; /* Where the scanner jumps when it meets a fatal error. */
+      compressedInput* input; /* The decompressed input read instead of the FILE of the scanner, or NULL. */
+  } scannerState;
   typedef struct {
       parameterList* parameters;
   } parameterInformation;
 
-#line 56 "src/parser/Parser.h"
+#line 65 "src/parser/Parser.h"
 
 /* Token kinds.  */
 #ifndef YYTOKENTYPE
@@ -92,12 +101,13 @@ extern int yydebug;
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
 union YYSTYPE
 {
-#line 47 "src/parser/Parser.y"
+#line 56 "src/parser/Parser.y"
 
-    char* name;
+    tokenView view;
+    int node;
     parameterInformation parameterInfo;
 
-#line 101 "src/parser/Parser.h"
+#line 111 "src/parser/Parser.h"
 
 };
 typedef union YYSTYPE YYSTYPE;
@@ -108,7 +118,7 @@ typedef union YYSTYPE YYSTYPE;
 
 
 
-int yyparse (GraphList *graph, yyscan_t scanner);
+int yyparse (GraphBuilder *graph, yyscan_t scanner);
 
 
 #endif /* !YY_YY_SRC_PARSER_PARSER_H_INCLUDED  */
@@ -3,7 +3,7 @@
  * @file Parser.l
  * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
  * @brief  Parser for a graphviz parser, intended to serve for a master's project at University of Bordeaux. Adapted from gvizparse by Nikolaos Kavvadias (https://github.com/nkkav/gvizparse v1.0.0).
- *         Convert a .dot file into a GraphList structure.
+ *         Convert a .dot file into a Graph, through a GraphBuilder.
            Does not support subgraphs for now.
            This version supports automata with custom syntax (nodes are declared initial (resp. final) with an option of the form "[initial=N]" (resp. "[final=N]"), with N standing for any string), and stores the color of the node (if any).
  * @version 2
@@ -13,12 +13,12 @@
  * 
  */
  
-#include "GraphList.h"
+#include "GraphBuilder.h"
 #include "Parser.h"
 #include "Lexer.h"
 #include "Graph.h"
 
-int yyerror(GraphList *expression, yyscan_t scanner, const char *msg) {
+int yyerror(GraphBuilder *builder, yyscan_t scanner, const char *msg) {
     /* Add error handling routine as needed */
     printf("Erreur: %s\n",msg);
     return 0;
@@ -27,7 +27,16 @@ int yyerror(GraphList *expression, yyscan_t scanner, const char *msg) {
 %}
 
 %code requires {
+  #include <setjmp.h>
+  #include "GraphBuilder.h"
+  #include "CompressedInput.h"
   typedef void* yyscan_t;
+  /* The extra data of a scanner, so that several scanners can run at the same time. */
+  typedef struct {
+      Arena tokens;     /* The arena in which tokens are copied, or NULL if the scanned buffer outlives the parse. */
+      jmp_buf on_error; /* Where the scanner jumps when it meets a fatal error. */
+      compressedInput* input; /* The decompressed input read instead of the FILE of the scanner, or NULL. */
+  } scannerState;
   typedef struct {
       parameterList* parameters;
   } parameterInformation;
@@ -40,12 +49,13 @@ int yyerror(GraphList *expression, yyscan_t scanner, const char *msg) {
  
 %define api.pure
 %lex-param   { yyscan_t scanner }
-%parse-param { GraphList *graph }
+%parse-param { GraphBuilder *graph }
 %parse-param { yyscan_t scanner }
 
 
 %union {
-    char* name;
+    tokenView view;
+    int node;
     parameterInformation parameterInfo;
 }
 
@@ -60,14 +70,14 @@ int yyerror(GraphList *expression, yyscan_t scanner, const char *msg) {
 %token T_RBRACKET
 %token T_LBRACE
 %token T_RBRACE
-%token <name> T_STRING
+%token <view> T_STRING
 %token T_EQ
 %token T_DIGRAPH
 %token T_EDGE
 %token T_DEDGE
 %token T_UEDGE
 %token T_GRAPH
-%token <name> T_ID
+%token <view> T_ID
 %token T_NODE
 %token T_STRICT
 %token T_SUBGRAPH
@@ -76,19 +86,19 @@ int yyerror(GraphList *expression, yyscan_t scanner, const char *msg) {
 /*declare non-terminal symbols here.*/
 //%type <expression> edgeDescription
 
-%type <name> node_id;
-%type <name> edgerhs;
+%type <node> node_id;
+%type <node> edgerhs;
 %type <parameterInfo> attr_assignment;
 %type <parameterInfo> a_list;
 %type <parameterInfo> attr_list;
-%type <name> idrhs;
+%type <view> idrhs;
 
 
 
  
 %%
  
-input : strict graph_type idrhs T_LBRACE stmt_list T_RBRACE {graph->name = $3;}
+input : strict graph_type idrhs T_LBRACE stmt_list T_RBRACE {graph_builder_set_name(graph,$3.start,$3.length);}
     ;
 
 strict : /* empty */ 
@@ -140,30 +150,24 @@ a_list : attr_assignment                { $$ = $1;}
     ;
 
 attr_assignment : idrhs T_EQ idrhs   { 
-      $$.parameters = parameter_list_add_parameter(NULL,$1,$3);
-             free($1); free($3);}
+      $$.parameters = graph_builder_new_parameter(graph,$1,$3);}
     ;
 								
-idrhs : T_ID        { $$ = (char*)malloc((strlen($1)+1)*sizeof(char)); strcpy($$,$1);
-                    }
-    | T_STRING      { $$ = (char*)malloc((strlen($1)+1)*sizeof(char)); strcpy($$,$1);
-                    }
+idrhs : T_ID        { $$ = $1; }
+    | T_STRING      { $$ = $1; }
 		;        
 
-node_stmt : node_id         { free($1); }
+node_stmt : node_id
     | node_id attr_list     {   
-                                add_parameters_to_node($1,$2.parameters,graph->nodes);
-                                free($1);
+                                graph_builder_add_node_parameters(graph,$1,$2.parameters);
                             }
     ;
 
 node_id : T_ID      { 
-                      $$ = (char*)malloc((strlen($1)+1)*sizeof(char)); strcpy($$,$1);
-                      if(graph->nodes == NULL) graph->nodes = addNode($1,NULL); else addOrUpdateNode($1,graph->nodes);
+                      $$ = graph_builder_add_node(graph,$1.start,$1.length);
                     }
     | T_ID port     { 
-                      $$ = (char*)malloc((strlen($1)+1)*sizeof(char)); strcpy($$,$1);
-                      if(graph->nodes == NULL) graph->nodes = addNode($1,NULL); else addOrUpdateNode($1,graph->nodes);
+                      $$ = graph_builder_add_node(graph,$1.start,$1.length);
                     }
     ;
 
@@ -180,13 +184,11 @@ port_location : T_COLON T_ID
 port_angle : T_AT T_ID
     ;
 
-edge_stmt : node_id edgerhs         { //printf("edge seen: (%s,%s)\n",$1,$2);
-                                      graph->edges = addEdge($1,$2,graph->edges,NULL);
-                                      free($1); free($2);
+edge_stmt : node_id edgerhs         { //printf("edge seen: (%d,%d)\n",$1,$2);
+                                      graph_builder_add_edge(graph,$1,$2,NULL);
                                     }
-    | node_id edgerhs attr_list     { //printf("edge seen: (%s,%s)\n",$1,$2);
-                                      graph->edges = addEdge($1,$2,graph->edges,$3.parameters);
-                                      free($1); free($2);
+    | node_id edgerhs attr_list     { //printf("edge seen: (%d,%d)\n",$1,$2);
+                                      graph_builder_add_edge(graph,$1,$2,$3.parameters);
                                     }
     | subgraph edgerhs 
     | subgraph edgerhs attr_list 
@@ -196,8 +198,7 @@ edgerhs : edgeop node_id        { //printf("edge end seen\n");
                                   $$ = $2;
                                 }
     | edgeop node_id edgerhs    {
-                                  graph->edges = addEdge($2,$3,graph->edges,NULL);
-                                  free($3);
+                                  graph_builder_add_edge(graph,$2,$3,NULL);
                                   $$ = $2;
                                 }
     ;
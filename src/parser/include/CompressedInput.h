@@ -0,0 +1,87 @@
+/**
+ * @file CompressedInput.h
+ * @brief  Streaming decompression of compressed inputs (gzip with zlib, and zstd when compiled with HAVE_ZSTD), read by the flex scanner through its YY_INPUT, without temporary file.
+ *         For large inputs, decompression runs on a thread of its own, a few chunks ahead of the scanner.
+ * @version 1
+ * @date 2026-10-16
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#ifndef COCA_COMPRESSEDINPUT_H_
+#define COCA_COMPRESSEDINPUT_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Compression formats, recognized from the first bytes of a file.
+ */
+typedef enum
+{
+    compression_none, ///< Not compressed.
+    compression_gzip, ///< gzip (magic bytes 1f 8b).
+    compression_zstd  ///< zstd (magic bytes 28 b5 2f fd).
+} compressionFormat;
+
+/**
+ * @brief A compressed file being decompressed.
+ */
+typedef struct compressedInput_s compressedInput;
+
+/**
+ * @brief Recognizes the compression format of a file from its first bytes.
+ *
+ * @param header The first bytes of the file.
+ * @param size Their number (at least 4 for zstd to be recognized).
+ * @return compressionFormat The format.
+ */
+compressionFormat compression_detect(const unsigned char *header, size_t size);
+
+/**
+ * @brief Returns the name of a compression format.
+ *
+ * @param format The format.
+ * @return const char* Its name.
+ */
+const char *compression_name(compressionFormat format);
+
+/**
+ * @brief Tells if this build can decompress a format (zstd needs HAVE_ZSTD).
+ *
+ * @param format A compression format.
+ * @return true if compressed_input_open accepts it.
+ */
+bool compression_supported(compressionFormat format);
+
+/**
+ * @brief Starts decompressing a file.
+ *
+ * @param fd A file descriptor opened for reading, positioned at the beginning of the compressed data. It is closed by compressed_input_close.
+ * @param format The compression format of the file.
+ * @param threaded Whether decompression runs on a separate thread.
+ * @return compressedInput* The input, or NULL if the format is not supported (the file descriptor is then not closed).
+ */
+compressedInput *compressed_input_open(int fd, compressionFormat format, bool threaded);
+
+/**
+ * @brief Reads decompressed characters.
+ *
+ * @param input The input.
+ * @param buffer Where the characters are written.
+ * @param size The maximal number of characters.
+ * @return size_t The number of characters written, 0 at the end of the data (or on an error, see compressed_input_close).
+ */
+size_t compressed_input_read(compressedInput *input, char *buffer, size_t size);
+
+/**
+ * @brief Stops decompressing, closes the file and frees the input.
+ *
+ * @param input The input.
+ * @return true if the data read so far was valid.
+ * @return false if it was corrupted or truncated.
+ */
+bool compressed_input_close(compressedInput *input);
+
+#endif /* DOT_PARSER_COMPRESSEDINPUT_H_ */
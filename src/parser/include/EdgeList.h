@@ -2,8 +2,9 @@
  * @file EdgeList.h
  * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
  * @brief  Structure to store a list of graph edges that can be dynamically modified. Used as a temporary structure during parsing before translating into a more static structure.
- * @version 1
- * @date 2018-11-10
+ *         Edges are stored in an append-only array, and refer to their nodes by their index in the NodeList.
+ * @version 2
+ * @date 2018-11-10, 2026-10-15
  * 
  * @copyright Creative Commons.
  * 
@@ -12,29 +13,44 @@
 #ifndef COCA_EDGELIST_H_
 #define COCA_EDGELIST_H_
 
+#include <stddef.h>
 #include "Graph.h"
 
 /**
- * @brief The EdgeList structure
+ * @brief An edge of an EdgeList.
+ */
+typedef struct
+{
+	int node1;				   ///< The index of the left node.
+	int node2;				   ///< The index of the right node.
+	parameterList *parameters; ///< The parameters of the edge.
+} SEdge;
+
+/**
+ * @brief The EdgeList structure: edges in the order they were added.
  */
 typedef struct tagSEdgeList
 {
-	char* node1;
-	char* node2;
-	parameterList *parameters;
-    struct tagSEdgeList *next;
+	SEdge *edges;	 ///< The edges.
+	size_t size;	 ///< The number of edges.
+	size_t capacity; ///< The size of edges.
 } SEdgeList;
 
 /**
- * @brief Adds an edge in front of a list (works if list is null).
- * @param n1 the left node
- * @param n2 the right node
+ * @brief Initializes an empty edge list.
+ *
+ * @param list the list to initialize.
+ */
+void initEdgeList(SEdgeList *list);
+
+/**
+ * @brief Adds an edge at the end of a list.
+ * @param n1 the index of the left node
+ * @param n2 the index of the right node
  * @param list the list to append to
  * @param parameters the parameters of the edge
- * @return the new list or NULl in case of no memory.
  */
-
-SEdgeList *addEdge(char* n1, char* n2, SEdgeList *list, parameterList *parameters);
+void addEdge(int n1, int n2, SEdgeList *list, parameterList *parameters);
 
 /**
  * @brief Prints an EdgeList.
@@ -44,10 +60,9 @@ SEdgeList *addEdge(char* n1, char* n2, SEdgeList *list, parameterList *parameter
 void printEdgeList(SEdgeList *e);
 
 /**
- * @brief Deletes an edge list
+ * @brief Frees the array of an edge list (parameters are in the arena of the GraphBuilder).
  * @param b The edge list
  */
-void deleteExpression(SEdgeList *b);
-
+void deleteEdgeList(SEdgeList *b);
 
 #endif /* DOT_PARSER_EDGELIST_H_ */
@@ -0,0 +1,30 @@
+/**
+ * @file FastParser.h
+ * @brief  Hand-written parser for the subset of the graphviz format used by our instances: a (di)graph whose statements are node statements, chains of edges and attribute assignments.
+ *         Delimiters are found with SIMD instructions (AVX2 or SSE2 when available, scalar code otherwise). Any other syntax makes it give up, so that the flex/bison parser handles the file instead.
+ * @version 1
+ * @date 2026-10-15
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#ifndef COCA_FASTPARSER_H_
+#define COCA_FASTPARSER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "GraphBuilder.h"
+
+/**
+ * @brief Parses a buffer with the fast parser, feeding the statements to @p builder in the same order as the flex/bison parser.
+ *
+ * @param buffer The characters to parse. They are not modified, and need not be null-terminated.
+ * @param size Their number.
+ * @param builder An initialized builder.
+ * @return true if the buffer was entirely parsed.
+ * @return false if it contains syntax the fast parser does not handle (or is not valid). The builder then holds a partial graph and must be deleted.
+ */
+bool fast_parse(const char *buffer, size_t size, GraphBuilder *builder);
+
+#endif /* DOT_PARSER_FASTPARSER_H_ */
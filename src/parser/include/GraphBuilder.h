@@ -0,0 +1,122 @@
+/**
+ * @file GraphBuilder.h
+ * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
+ * @brief  Builds a graph directly from the actions of the parser. Node names are allocated once, in the arena of the final graph, and statements only record node indices, so that no intermediate copy of the graph is made.
+ * @version 3
+ * @date 2020-06-24, 2026-10-15
+ * 
+ * @copyright Creative Commons.
+ * 
+ */
+
+#ifndef COCA_GRAPHBUILDER_H_
+#define COCA_GRAPHBUILDER_H_
+
+#include "EdgeList.h"
+#include "NodeList.h"
+#include "Graph.h"
+
+/**
+ * @brief A token of the source, as a sequence of characters which is not null-terminated.
+ */
+typedef struct
+{
+    const char *start; ///< The first character.
+    size_t length;     ///< The number of characters.
+} tokenView;
+
+/**
+ * @brief A graph under construction.
+ */
+typedef struct tagGraphBuilder
+{
+    char *name;              ///< The name of the graph (in structure_arena).
+    SNodeList nodes;         ///< The nodes, indexed by name. Their names are in structure_arena.
+    SEdgeList edges;         ///< The edges, in order of appearance.
+    bool directed;           ///< true if the graph is directed.
+    Arena structure_arena;   ///< The structure arena of the graph to build.
+    Arena parameters_arena;  ///< The parameters arena of the graph to build.
+    Arena arena;             ///< Scratch arena for the parameter lists of the statements, released by graph_builder_finish.
+    Arena source_arena;      ///< If not NULL, the source of the tokens, which outlives the graph: parameter values are kept as spans of it (see graph_builder_set_source).
+} GraphBuilder;
+
+/**
+ * @brief Initializes an empty builder.
+ * 
+ * @param builder the builder to initialize.
+ */
+void graph_builder_init(GraphBuilder *builder);
+
+/**
+ * @brief Sets the name of the graph.
+ * 
+ * @param builder the builder.
+ * @param name the name (copied, need not be null-terminated).
+ * @param length the length of the name.
+ */
+void graph_builder_set_name(GraphBuilder *builder, const char *name, size_t length);
+
+/**
+ * @brief Makes the builder keep the values of parameters as spans of the source, decoded the first time they are read, instead of interning them.
+ *        The graph built keeps a reference to @p source, so the tokens given to the builder must live as long as this arena.
+ * 
+ * @param builder the builder.
+ * @param source an arena whose release frees the source (a reference is added).
+ */
+void graph_builder_set_source(GraphBuilder *builder, Arena source);
+
+/**
+ * @brief Returns a list made of one parameter of a statement, allocated in the scratch arena.
+ * 
+ * @param builder the builder.
+ * @param name the name of the parameter.
+ * @param value its value, kept as a span of the source if the builder has one.
+ * @return parameterList* the list.
+ */
+parameterList *graph_builder_new_parameter(GraphBuilder *builder, tokenView name, tokenView value);
+
+/**
+ * @brief Returns the index of the node named @p name, adding it if it was not seen before.
+ * 
+ * @param builder the builder.
+ * @param name the name of the node (copied in the graph if the node is new, need not be null-terminated).
+ * @param length the length of the name.
+ * @return int the index of the node.
+ */
+int graph_builder_add_node(GraphBuilder *builder, const char *name, size_t length);
+
+/**
+ * @brief Adds parameters to a node.
+ * 
+ * @param builder the builder.
+ * @param node the index of the node.
+ * @param parameters the parameters, allocated in the arena of the builder.
+ */
+void graph_builder_add_node_parameters(GraphBuilder *builder, int node, parameterList *parameters);
+
+/**
+ * @brief Adds an edge statement. For undirected graphs, it is added in both directions when the graph is finished.
+ * 
+ * @param builder the builder.
+ * @param source the index of the source node.
+ * @param target the index of the target node.
+ * @param parameters the parameters of the edge, allocated in the arena of the builder.
+ */
+void graph_builder_add_edge(GraphBuilder *builder, int source, int target, parameterList *parameters);
+
+/**
+ * @brief Frees everything held by the builder without building the graph (when a parse is abandoned).
+ * 
+ * @param builder the builder, which must not be used afterwards (unless initialized again).
+ */
+void graph_builder_delete(GraphBuilder *builder);
+
+/**
+ * @brief Builds the graph and frees everything else held by the builder, which must not be used afterwards.
+ * 
+ * @param builder the builder.
+ * @return Graph the graph described by the statements given to the builder.
+ */
+Graph graph_builder_finish(GraphBuilder *builder);
+
+#endif /* DOT_PARSER_GRAPHBUILDER_H_ */
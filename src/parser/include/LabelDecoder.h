@@ -0,0 +1,58 @@
+/**
+ * @file LabelDecoder.h
+ * @brief  Decodes the actions of the nodes of a tunnel network from their labels while the graph is built, so that the network does not process strings.
+ *         A label lists actions such as "4→4", "4↑46" or "46↓4", separated by "\n". The mask of a label has the bit i set for the i-th action of stack_action (TunnelNetwork.h):
+ *         →4, →6, ↑_4^4, ↑_4^6, ↑_6^4, ↑_6^6, ↓_4^4, ↓_4^6, ↓_6^4, ↓_6^6.
+ * @version 1
+ * @date 2026-10-15
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#ifndef COCA_LABELDECODER_H_
+#define COCA_LABELDECODER_H_
+
+#include <stddef.h>
+#include "Atoms.h"
+
+/**
+ * @brief The number of labels remembered by a decoder.
+ */
+#define LABEL_CACHE_SIZE 64
+
+/**
+ * @brief Decodes labels given as atoms. The same labels are usually repeated on many nodes: the last decoded labels are remembered, so that each is read once.
+ */
+typedef struct
+{
+    atom labels[LABEL_CACHE_SIZE]; ///< The labels remembered (NO_ATOM if none), indexed by their atom modulo LABEL_CACHE_SIZE.
+    int actions[LABEL_CACHE_SIZE]; ///< Their masks of actions.
+} labelDecoder;
+
+/**
+ * @brief Returns the mask of the actions listed in a label. Unknown tokens are ignored.
+ *
+ * @param label The characters of the label (quotes included or not), which need not be null-terminated.
+ * @param length Their number.
+ * @return int The mask of actions.
+ */
+int label_decode_actions(const char *label, size_t length);
+
+/**
+ * @brief Initializes a decoder remembering no label.
+ *
+ * @param decoder The decoder.
+ */
+void label_decoder_init(labelDecoder *decoder);
+
+/**
+ * @brief Returns the mask of the actions listed in a label.
+ *
+ * @param decoder The decoder.
+ * @param label The atom of the label (NO_ATOM gives an empty mask).
+ * @return int The mask of actions.
+ */
+int label_decoder_actions(labelDecoder *decoder, atom label);
+
+#endif /* DOT_PARSER_LABELDECODER_H_ */
@@ -2,9 +2,9 @@
  * @file NodeList.h
  * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
  * @brief  Structure to store a list of graph nodes that can be dynamically modified. Used as a temporary structure during parsing before translating into a more static structure.
- *         Includes automata features (initial and final nodes), and color of nodes.
- * @version 2
- * @date 2019-06-24
+ *         Nodes are stored in an append-only array, indexed by a hash table on their names, so that adding or finding a node takes constant (expected) time.
+ * @version 3
+ * @date 2019-06-24, 2026-10-15
  *
  * @copyright Creative Commons.
  *
@@ -17,40 +17,71 @@
 #include "Graph.h"
 
 /**
- * @brief The NodeList structure
+ * @brief A node of a NodeList.
+ */
+typedef struct
+{
+    char *node;                ///< The name of the node.
+    size_t length;             ///< The length of the name.
+    parameterList *parameters; ///< Its parameters.
+} SNode;
+
+/**
+ * @brief The NodeList structure: nodes in order of first appearance.
  */
 typedef struct tagSNodeList
 {
-    char *node;
-    parameterList *parameters;
-    struct tagSNodeList *next;
+    SNode *nodes;      ///< The nodes.
+    int size;          ///< The number of nodes.
+    int capacity;      ///< The size of nodes.
+    int *slots;        ///< Open-addressed index from names to nodes (-1 for a free slot).
+    size_t num_slots;  ///< The number of slots (0 or a power of 2).
 } SNodeList;
 
 /**
- * @brief Adds a node in front of a list (works if list is null).
- * @param n1 the node
- * @param list the list to append to
- * @return the new list or NULL in case of no memory.
+ * @brief Initializes an empty node list.
+ *
+ * @param list the list to initialize.
  */
-
-SNodeList *addNode(char *n1, SNodeList *list);
+void initNodeList(SNodeList *list);
 
 /**
- * @brief If n is present in the list, does nothing. Otherwise, adds the node at the end of the list.
+ * @brief If a node named n is present in the list, returns its index. Otherwise, adds the node at the end of the list.
  *
- * @param n the node to add.
+ * @param arena the arena in which the name of a new node is copied.
+ * @param n the name of the node to add (need not be null-terminated).
+ * @param length the length of the name.
  * @param list the list to modify.
+ * @return int the index of the node named n in list.
+ */
+int addOrUpdateNode(Arena arena, const char *n, size_t length, SNodeList *list);
+
+/**
+ * @brief Returns the index of the node named n in list, or -1 if it is not present.
+ *
+ * @param n the name of a node.
+ * @param list the list of nodes.
+ * @return int the index of n, or -1.
+ */
+int findNodeInList(const char *n, SNodeList *list);
+
+/**
+ * @brief Hands the index from names to nodes over to the caller, who frees it. The list keeps its nodes, and has no index afterwards.
+ *
+ * @param list the list of nodes.
+ * @param num_slots where to store the number of slots of the index (a nonzero power of 2, at least twice the number of nodes).
+ * @return int* the slots of the index (see graph_name_slot), -1 for a free slot.
  */
-void addOrUpdateNode(char *n, SNodeList *list);
+int *takeNodeIndex(SNodeList *list, size_t *num_slots);
 
 /**
- * @brief Adds the parameter list parameters to node node if node is present in the list of nodes list.
+ * @brief Adds the parameter list parameters to the node of index node.
  *
- * @param node the node to which to add a parameter.
+ * @param node the index of the node to which to add a parameter.
  * @param parameters the list of parameters to add to node.
  * @param list the list of nodes.
  */
-void add_parameters_to_node(char *node, parameterList *parameters, SNodeList *list);
+void add_parameters_to_node(int node, parameterList *parameters, SNodeList *list);
 
 /**
  * @brief Prints a NodeList.
@@ -60,7 +91,7 @@ void add_parameters_to_node(char *node, parameterList *parameters, SNodeList *li
 void printNodeList(SNodeList *e);
 
 /**
- * @brief Deletes a node list
+ * @brief Frees the arrays of a node list (names and parameters are in arenas of the GraphBuilder).
  * @param b The node list
  */
 void deleteNodeList(SNodeList *b);
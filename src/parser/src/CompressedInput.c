@@ -0,0 +1,334 @@
+#include "CompressedInput.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+/**
+ * @brief The number of compressed bytes read from the file at once.
+ */
+#define COMPRESSED_READ_SIZE 65536
+
+/**
+ * @brief The size of the chunks of decompressed characters passed from the decompressing thread to the scanner.
+ */
+#define DECOMPRESSED_CHUNK_SIZE (256 * 1024)
+
+/**
+ * @brief The number of chunks decompressed in advance.
+ */
+#define DECOMPRESSED_NUM_CHUNKS 4
+
+/**
+ * @brief A chunk of decompressed characters.
+ */
+typedef struct
+{
+    char *data;  ///< The characters (DECOMPRESSED_CHUNK_SIZE allocated).
+    size_t size; ///< The number of characters.
+} decompressedChunk;
+
+struct compressedInput_s
+{
+    int fd;                   ///< The compressed file.
+    compressionFormat format; ///< Its format.
+    z_stream gzip;            ///< The state of zlib (gzip).
+#ifdef HAVE_ZSTD
+    ZSTD_DStream *zstd; ///< The state of zstd.
+#endif
+    unsigned char *in;  ///< The compressed bytes read.
+    size_t in_size;     ///< Their number.
+    size_t in_position; ///< The number of them already decompressed.
+    bool in_end;        ///< Whether the end of the file was reached.
+    bool frame_ended;   ///< Whether the last gzip member or zstd frame decompressed is complete.
+    bool failed;        ///< Whether the data was found corrupted or truncated.
+
+    bool threaded;                                     ///< Whether a thread decompresses in advance into chunks.
+    pthread_t decompressor;                            ///< That thread.
+    decompressedChunk chunks[DECOMPRESSED_NUM_CHUNKS]; ///< The chunks, in a circular buffer.
+    int first;                                         ///< The position of the first full chunk.
+    int count;                                         ///< The number of full chunks.
+    size_t consumed;                                   ///< The number of characters of the first chunk already read.
+    bool finished;                                     ///< Whether the decompressing thread reached the end of the data.
+    bool closing;                                      ///< Whether the input is being closed.
+    pthread_mutex_t mutex;                             ///< Protects the chunks and the flags.
+    pthread_cond_t not_empty;                          ///< Signalled when a chunk is filled, or the decompression finishes.
+    pthread_cond_t not_full;                           ///< Signalled when a chunk is read, or the input is closed.
+};
+
+compressionFormat compression_detect(const unsigned char *header, size_t size)
+{
+    if (size >= 2 && header[0] == 0x1f && header[1] == 0x8b)
+        return compression_gzip;
+    if (size >= 4 && header[0] == 0x28 && header[1] == 0xb5 && header[2] == 0x2f && header[3] == 0xfd)
+        return compression_zstd;
+    return compression_none;
+}
+
+const char *compression_name(compressionFormat format)
+{
+    switch (format)
+    {
+    case compression_gzip:
+        return "gzip";
+    case compression_zstd:
+        return "zstd";
+    default:
+        return "none";
+    }
+}
+
+bool compression_supported(compressionFormat format)
+{
+#ifdef HAVE_ZSTD
+    return format == compression_gzip || format == compression_zstd;
+#else
+    return format == compression_gzip;
+#endif
+}
+
+/**
+ * @brief Decompresses some of the compressed bytes read, without reading the file.
+ *        Several gzip members (or zstd frames) may follow each other, as produced by concatenating compressed files.
+ *
+ * @param input The input.
+ * @param output Where the characters are written.
+ * @param size The room in @p output (positive).
+ * @return size_t The number of characters written.
+ */
+static size_t decompress_step(compressedInput *input, char *output, size_t size)
+{
+    size_t available = input->in_size - input->in_position;
+    if (input->format == compression_gzip)
+    {
+        input->gzip.next_in = input->in + input->in_position;
+        input->gzip.avail_in = available;
+        input->gzip.next_out = (unsigned char *)output;
+        input->gzip.avail_out = size;
+        int status = inflate(&input->gzip, Z_NO_FLUSH);
+        input->in_position = input->in_size - input->gzip.avail_in;
+        if (status == Z_STREAM_END)
+        {
+            input->frame_ended = true;
+            inflateReset(&input->gzip);
+        }
+        else if (status == Z_OK || status == Z_BUF_ERROR)
+            input->frame_ended = input->frame_ended && input->gzip.avail_in == available;
+        else
+            input->failed = true;
+        return size - input->gzip.avail_out;
+    }
+#ifdef HAVE_ZSTD
+    ZSTD_inBuffer in = {input->in, input->in_size, input->in_position};
+    ZSTD_outBuffer out = {output, size, 0};
+    size_t status = ZSTD_decompressStream(input->zstd, &out, &in);
+    // Once a frame is complete, a call without input already expects the next one: only progress tells where the data stands.
+    bool progress = in.pos > input->in_position || out.pos > 0;
+    input->in_position = in.pos;
+    if (ZSTD_isError(status))
+        input->failed = true;
+    else if (progress)
+        input->frame_ended = status == 0;
+    return out.pos;
+#else
+    input->failed = true;
+    return 0;
+#endif
+}
+
+/**
+ * @brief Decompresses characters, reading the file as needed.
+ *
+ * @param input The input.
+ * @param output Where the characters are written.
+ * @param size The room in @p output (positive).
+ * @return size_t The number of characters written, 0 at the end of the data or on an error.
+ */
+static size_t decompress(compressedInput *input, char *output, size_t size)
+{
+    while (!input->failed)
+    {
+        size_t position = input->in_position;
+        size_t produced = decompress_step(input, output, size);
+        if (produced > 0 || input->failed)
+            return produced;
+        if (input->in_position < input->in_size)
+        {
+            // Bytes are always either consumed or decompressed, unless the data is invalid.
+            if (input->in_position == position)
+                input->failed = true;
+            continue;
+        }
+        if (input->in_end)
+        {
+            input->failed = !input->frame_ended;
+            return 0;
+        }
+        ssize_t num_read = read(input->fd, input->in, COMPRESSED_READ_SIZE);
+        if (num_read < 0)
+            input->failed = true;
+        else if (num_read == 0)
+            input->in_end = true;
+        input->in_size = num_read < 0 ? 0 : num_read;
+        input->in_position = 0;
+    }
+    return 0;
+}
+
+/**
+ * @brief Decompresses the whole input into chunks, a few chunks ahead of the reader.
+ *
+ * @param data The compressedInput.
+ * @return void* NULL.
+ */
+static void *decompress_chunks(void *data)
+{
+    compressedInput *input = (compressedInput *)data;
+    bool end = false;
+    while (!end)
+    {
+        pthread_mutex_lock(&input->mutex);
+        while (input->count == DECOMPRESSED_NUM_CHUNKS && !input->closing)
+            pthread_cond_wait(&input->not_full, &input->mutex);
+        if (input->closing)
+        {
+            pthread_mutex_unlock(&input->mutex);
+            break;
+        }
+        // Only this thread writes in the chunks that are not full.
+        decompressedChunk *chunk = &input->chunks[(input->first + input->count) % DECOMPRESSED_NUM_CHUNKS];
+        pthread_mutex_unlock(&input->mutex);
+
+        chunk->size = 0;
+        while (chunk->size < DECOMPRESSED_CHUNK_SIZE)
+        {
+            size_t produced = decompress(input, chunk->data + chunk->size, DECOMPRESSED_CHUNK_SIZE - chunk->size);
+            if (produced == 0)
+            {
+                end = true;
+                break;
+            }
+            chunk->size += produced;
+        }
+
+        pthread_mutex_lock(&input->mutex);
+        if (chunk->size > 0)
+            input->count++;
+        input->finished = end;
+        pthread_cond_signal(&input->not_empty);
+        pthread_mutex_unlock(&input->mutex);
+    }
+    return NULL;
+}
+
+compressedInput *compressed_input_open(int fd, compressionFormat format, bool threaded)
+{
+    if (!compression_supported(format))
+        return NULL;
+    compressedInput *input = (compressedInput *)calloc(1, sizeof(compressedInput));
+    input->fd = fd;
+    input->format = format;
+    if (format == compression_gzip)
+    {
+        // 15 + 32: the largest window, with detection of the gzip (or zlib) header.
+        if (inflateInit2(&input->gzip, 15 + 32) != Z_OK)
+        {
+            free(input);
+            return NULL;
+        }
+    }
+#ifdef HAVE_ZSTD
+    else
+        input->zstd = ZSTD_createDStream();
+#endif
+    input->in = (unsigned char *)malloc(COMPRESSED_READ_SIZE);
+    input->frame_ended = true;
+
+    if (threaded)
+    {
+        for (int i = 0; i < DECOMPRESSED_NUM_CHUNKS; i++)
+            input->chunks[i].data = (char *)malloc(DECOMPRESSED_CHUNK_SIZE);
+        pthread_mutex_init(&input->mutex, NULL);
+        pthread_cond_init(&input->not_empty, NULL);
+        pthread_cond_init(&input->not_full, NULL);
+        input->threaded = pthread_create(&input->decompressor, NULL, decompress_chunks, input) == 0;
+        // Without thread, the decompression is done by the reader.
+        if (!input->threaded)
+        {
+            pthread_cond_destroy(&input->not_full);
+            pthread_cond_destroy(&input->not_empty);
+            pthread_mutex_destroy(&input->mutex);
+            for (int i = 0; i < DECOMPRESSED_NUM_CHUNKS; i++)
+                free(input->chunks[i].data);
+        }
+    }
+    return input;
+}
+
+size_t compressed_input_read(compressedInput *input, char *buffer, size_t size)
+{
+    if (size == 0)
+        return 0;
+    if (!input->threaded)
+        return decompress(input, buffer, size);
+
+    pthread_mutex_lock(&input->mutex);
+    while (input->count == 0 && !input->finished)
+        pthread_cond_wait(&input->not_empty, &input->mutex);
+    if (input->count == 0)
+    {
+        pthread_mutex_unlock(&input->mutex);
+        return 0;
+    }
+    decompressedChunk *chunk = &input->chunks[input->first];
+    pthread_mutex_unlock(&input->mutex);
+
+    // The first full chunk is only modified by the reader, until it is given back.
+    size_t copied = chunk->size - input->consumed;
+    if (copied > size)
+        copied = size;
+    memcpy(buffer, chunk->data + input->consumed, copied);
+    input->consumed += copied;
+    if (input->consumed == chunk->size)
+    {
+        pthread_mutex_lock(&input->mutex);
+        input->consumed = 0;
+        input->first = (input->first + 1) % DECOMPRESSED_NUM_CHUNKS;
+        input->count--;
+        pthread_cond_signal(&input->not_full);
+        pthread_mutex_unlock(&input->mutex);
+    }
+    return copied;
+}
+
+bool compressed_input_close(compressedInput *input)
+{
+    if (input->threaded)
+    {
+        pthread_mutex_lock(&input->mutex);
+        input->closing = true;
+        pthread_cond_signal(&input->not_full);
+        pthread_mutex_unlock(&input->mutex);
+        pthread_join(input->decompressor, NULL);
+        pthread_cond_destroy(&input->not_full);
+        pthread_cond_destroy(&input->not_empty);
+        pthread_mutex_destroy(&input->mutex);
+        for (int i = 0; i < DECOMPRESSED_NUM_CHUNKS; i++)
+            free(input->chunks[i].data);
+    }
+    if (input->format == compression_gzip)
+        inflateEnd(&input->gzip);
+#ifdef HAVE_ZSTD
+    else
+        ZSTD_freeDStream(input->zstd);
+#endif
+    bool valid = !input->failed;
+    free(input->in);
+    close(input->fd);
+    free(input);
+    return valid;
+}
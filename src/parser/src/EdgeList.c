@@ -2,8 +2,8 @@
  * @file EdgeList.c
  * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
  * @brief  Structure to store a list of graph edges that can be dynamically modified. Used as a temporary structure during parsing before translating into a more static structure.
- * @version 1
- * @date 2018-11-10
+ * @version 2
+ * @date 2018-11-10, 2026-10-15
  *
  * @copyright Creative Commons.
  *
@@ -15,67 +15,35 @@
 #include <stdlib.h>
 #include <string.h>
 
-/**
- * @brief Allocates space for edge list
- * @return The expression or NULL if not enough memory
- */
-static SEdgeList *allocateEdgeList()
+void initEdgeList(SEdgeList *list)
 {
-    SEdgeList *b = (SEdgeList *)malloc(sizeof(SEdgeList));
-
-    if (b == NULL)
-        return NULL;
-
-    b->node1 = NULL;
-    b->node2 = NULL;
-    b->parameters = NULL;
-
-    b->next = NULL;
-
-    return b;
+    list->edges = NULL;
+    list->size = 0;
+    list->capacity = 0;
 }
 
-SEdgeList *addEdge(char *n1, char *n2, SEdgeList *list, parameterList *parameters)
+void addEdge(int n1, int n2, SEdgeList *list, parameterList *parameters)
 {
-    SEdgeList *b = allocateEdgeList();
-
-    if (b == NULL)
-        return NULL;
-
-    b->node1 = (char *)malloc((strlen(n1) + 1) * sizeof(char));
-    strcpy(b->node1, n1);
-    b->node2 = (char *)malloc((strlen(n2) + 1) * sizeof(char));
-    strcpy(b->node2, n2);
-
-    b->parameters = parameters;
-
-    b->next = list;
-
-    return b;
+    if (list->size == list->capacity)
+    {
+        list->capacity = list->capacity == 0 ? 64 : 2 * list->capacity;
+        list->edges = (SEdge *)realloc(list->edges, list->capacity * sizeof(SEdge));
+    }
+    list->edges[list->size].node1 = n1;
+    list->edges[list->size].node2 = n2;
+    list->edges[list->size].parameters = parameters;
+    list->size++;
 }
 
 void printEdgeList(SEdgeList *e)
 {
-    if (e == NULL)
-    {
-        printf("\n");
-        return;
-    }
-    printf("(%s,%s) -- ", e->node1, e->node2);
-    printEdgeList(e->next);
+    for (size_t i = 0; i < e->size; i++)
+        printf("(%d,%d) -- ", e->edges[i].node1, e->edges[i].node2);
+    printf("\n");
 }
 
-void deleteExpression(SEdgeList *b)
+void deleteEdgeList(SEdgeList *b)
 {
-    if (b == NULL)
-        return;
-
-    deleteExpression(b->next);
-
-    free(b->node1);
-    free(b->node2);
-
-    parameter_list_delete(b->parameters);
-
-    free(b);
+    free(b->edges);
+    initEdgeList(b);
 }
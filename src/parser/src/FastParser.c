@@ -0,0 +1,462 @@
+/**
+ * @file FastParser.c
+ * @brief  Hand-written parser for the subset of the graphviz format used by our instances.
+ *         It accepts exactly the same tokens as Lexer.l (identifiers, quoted strings, // comments), and gives up on keywords other than strict, digraph and graph in the header,
+ *         on ports, subgraphs and on anything the flex/bison parser would reject.
+ * @version 1
+ * @date 2026-10-15
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#include "FastParser.h"
+#include <stdlib.h>
+#include <string.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief The tokens of the subset.
+ */
+typedef enum
+{
+    FAST_END,        ///< End of the buffer.
+    FAST_ID,         ///< An identifier.
+    FAST_STRING,     ///< A quoted string (with its quotes).
+    FAST_STRICT,     ///< The keyword strict.
+    FAST_DIGRAPH,    ///< The keyword digraph.
+    FAST_GRAPH,      ///< The keyword graph.
+    FAST_LBRACKET,   ///< [
+    FAST_RBRACKET,   ///< ]
+    FAST_LBRACE,     ///< {
+    FAST_RBRACE,     ///< }
+    FAST_COMMA,      ///< ,
+    FAST_SEMI,       ///< ;
+    FAST_EQ,         ///< =
+    FAST_EDGEOP,     ///< -> or --
+    FAST_UNSUPPORTED ///< Anything else (including the other keywords).
+} fastToken;
+
+/**
+ * @brief The state of the fast parser.
+ */
+typedef struct
+{
+    const char *current;   ///< The next character to scan.
+    const char *end;       ///< The end of the buffer.
+    tokenView view;        ///< The characters of the last identifier or string.
+    GraphBuilder *builder; ///< The builder fed with the statements.
+    int *chain;            ///< The nodes of the current chain of edges.
+    size_t chain_capacity; ///< The size of chain.
+} fastParser;
+
+/**
+ * @brief Tells if a character may appear in an identifier after its first character.
+ * @param c A character.
+ * @return true if @p c is in [a-zA-Z0-9_.].
+ */
+static bool is_identifier_char(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '.';
+}
+
+/**
+ * @brief Tells if a character is a white space for Lexer.l.
+ * @param c A character.
+ * @return true if @p c is a space, a tabulation or a newline.
+ */
+static bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n';
+}
+
+#ifdef __AVX2__
+/**
+ * @brief Mask of the bytes of a chunk which are characters of identifiers.
+ * @param chunk 32 characters.
+ * @return __m256i 0xFF for the characters in [a-zA-Z0-9_.], 0 for the others.
+ */
+static __m256i identifier_mask_avx2(__m256i chunk)
+{
+    __m256i lower = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+    __m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+    __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(chunk, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), chunk));
+    __m256i other = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('_')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('.')));
+    return _mm256_or_si256(_mm256_or_si256(letter, digit), other);
+}
+#endif
+
+#ifdef __SSE2__
+/**
+ * @brief Mask of the bytes of a chunk which are characters of identifiers.
+ * @param chunk 16 characters.
+ * @return __m128i 0xFF for the characters in [a-zA-Z0-9_.], 0 for the others.
+ */
+static __m128i identifier_mask_sse2(__m128i chunk)
+{
+    __m128i lower = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+    __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(chunk, _mm_set1_epi8('9' + 1)));
+    __m128i other = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('_')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('.')));
+    return _mm_or_si128(_mm_or_si128(letter, digit), other);
+}
+#endif
+
+/**
+ * @brief Returns the first character from @p p which is not a character of an identifier.
+ * @param p The first character to test.
+ * @param end The end of the buffer.
+ * @return const char* The first character not in [a-zA-Z0-9_.], or @p end.
+ */
+static const char *skip_identifier(const char *p, const char *end)
+{
+#ifdef __AVX2__
+    for (; end - p >= 32; p += 32)
+    {
+        unsigned mask = ~(unsigned)_mm256_movemask_epi8(identifier_mask_avx2(_mm256_loadu_si256((const __m256i *)p)));
+        if (mask != 0)
+            return p + __builtin_ctz(mask);
+    }
+#endif
+#ifdef __SSE2__
+    for (; end - p >= 16; p += 16)
+    {
+        unsigned mask = ~(unsigned)_mm_movemask_epi8(identifier_mask_sse2(_mm_loadu_si128((const __m128i *)p))) & 0xFFFF;
+        if (mask != 0)
+            return p + __builtin_ctz(mask);
+    }
+#endif
+    while (p < end && is_identifier_char(*p))
+        p++;
+    return p;
+}
+
+/**
+ * @brief Returns the first character from @p p which is not a white space.
+ * @param p The first character to test.
+ * @param end The end of the buffer.
+ * @return const char* The first character which is not a space, a tabulation or a newline, or @p end.
+ */
+static const char *skip_spaces(const char *p, const char *end)
+{
+    // Most spaces are single ones between tokens or short indentations: only use vectors for longer runs.
+    if (p < end && !is_space(*p))
+        return p;
+#ifdef __AVX2__
+    for (; end - p >= 32; p += 32)
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)p);
+        __m256i space = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'))),
+                                        _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')));
+        unsigned mask = ~(unsigned)_mm256_movemask_epi8(space);
+        if (mask != 0)
+            return p + __builtin_ctz(mask);
+    }
+#endif
+#ifdef __SSE2__
+    for (; end - p >= 16; p += 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+        __m128i space = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))),
+                                     _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')));
+        unsigned mask = ~(unsigned)_mm_movemask_epi8(space) & 0xFFFF;
+        if (mask != 0)
+            return p + __builtin_ctz(mask);
+    }
+#endif
+    while (p < end && is_space(*p))
+        p++;
+    return p;
+}
+
+/**
+ * @brief Returns the first quote or backslash from @p p.
+ * @param p The first character to test.
+ * @param end The end of the buffer.
+ * @return const char* The first '"' or '\\', or @p end.
+ */
+static const char *find_quote(const char *p, const char *end)
+{
+#ifdef __AVX2__
+    for (; end - p >= 32; p += 32)
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)p);
+        unsigned mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'))));
+        if (mask != 0)
+            return p + __builtin_ctz(mask);
+    }
+#endif
+#ifdef __SSE2__
+    for (; end - p >= 16; p += 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+        unsigned mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))));
+        if (mask != 0)
+            return p + __builtin_ctz(mask);
+    }
+#endif
+    while (p < end && *p != '"' && *p != '\\')
+        p++;
+    return p;
+}
+
+/**
+ * @brief Compares an identifier with a keyword, ignoring case.
+ * @param view The identifier.
+ * @param keyword The keyword, in lower case.
+ * @return true if they are equal.
+ */
+static bool is_keyword(tokenView view, const char *keyword)
+{
+    if (strlen(keyword) != view.length)
+        return false;
+    for (size_t i = 0; i < view.length; i++)
+        if ((view.start[i] | 0x20) != keyword[i])
+            return false;
+    return true;
+}
+
+/**
+ * @brief Reads the next token. The characters of identifiers and strings are stored in the view of the parser.
+ * @param parser The parser.
+ * @return fastToken The token read.
+ */
+static fastToken next_token(fastParser *parser)
+{
+    const char *p = skip_spaces(parser->current, parser->end);
+    while (parser->end - p >= 2 && p[0] == '/' && p[1] == '/')
+    {
+        const char *newline = memchr(p, '\n', parser->end - p);
+        p = skip_spaces(newline == NULL ? parser->end : newline, parser->end);
+    }
+    parser->current = p + 1;
+    if (p == parser->end)
+    {
+        parser->current = p;
+        return FAST_END;
+    }
+    switch (*p)
+    {
+    case '[':
+        return FAST_LBRACKET;
+    case ']':
+        return FAST_RBRACKET;
+    case '{':
+        return FAST_LBRACE;
+    case '}':
+        return FAST_RBRACE;
+    case ',':
+        return FAST_COMMA;
+    case ';':
+        return FAST_SEMI;
+    case '=':
+        return FAST_EQ;
+    case '-':
+        if (parser->end - p < 2 || (p[1] != '>' && p[1] != '-'))
+            return FAST_UNSUPPORTED;
+        parser->current = p + 2;
+        return FAST_EDGEOP;
+    case '"':
+    {
+        const char *q = p + 1;
+        for (;;)
+        {
+            q = find_quote(q, parser->end);
+            if (q == parser->end)
+                return FAST_UNSUPPORTED;
+            if (*q == '"')
+                break;
+            // An escaped character, which cannot be a newline for Lexer.l.
+            if (parser->end - q < 2 || q[1] == '\n')
+                return FAST_UNSUPPORTED;
+            q += 2;
+        }
+        parser->view.start = p;
+        parser->view.length = q + 1 - p;
+        parser->current = q + 1;
+        return FAST_STRING;
+    }
+    default:
+        if (*p == '.' || !is_identifier_char(*p))
+            return FAST_UNSUPPORTED;
+        parser->current = skip_identifier(p + 1, parser->end);
+        parser->view.start = p;
+        parser->view.length = parser->current - p;
+        // Keywords have priority over identifiers of the same length in Lexer.l.
+        switch (*p | 0x20)
+        {
+        case 's':
+            if (is_keyword(parser->view, "strict"))
+                return FAST_STRICT;
+            return is_keyword(parser->view, "subgraph") ? FAST_UNSUPPORTED : FAST_ID;
+        case 'd':
+            return is_keyword(parser->view, "digraph") ? FAST_DIGRAPH : FAST_ID;
+        case 'g':
+            return is_keyword(parser->view, "graph") ? FAST_GRAPH : FAST_ID;
+        case 'n':
+            return is_keyword(parser->view, "node") ? FAST_UNSUPPORTED : FAST_ID;
+        case 'e':
+            return is_keyword(parser->view, "edge") ? FAST_UNSUPPORTED : FAST_ID;
+        case 'a':
+            return is_keyword(parser->view, "at") ? FAST_UNSUPPORTED : FAST_ID;
+        default:
+            return FAST_ID;
+        }
+    }
+}
+
+/**
+ * @brief Interns the view of the parser.
+ * @param parser The parser.
+ * @return atom The atom of the last identifier or string.
+ */
+static atom view_atom(fastParser *parser)
+{
+    return atom_intern_length(parser->view.start, parser->view.length);
+}
+
+/**
+ * @brief Parses a sequence of attribute lists, starting at a left bracket.
+ * @param parser The parser.
+ * @param token The current token (a left bracket), replaced by the token following the lists.
+ * @param parameters The address where the parameters are stored (allocated in the scratch arena of the builder).
+ * @return true if the lists were correct.
+ */
+static bool parse_attributes(fastParser *parser, fastToken *token, parameterList **parameters)
+{
+    parameterList **last = parameters;
+    *last = NULL;
+    while (*token == FAST_LBRACKET)
+    {
+        *token = next_token(parser);
+        if (*token == FAST_RBRACKET)
+        {
+            *token = next_token(parser);
+            continue;
+        }
+        for (;;)
+        {
+            if (*token != FAST_ID && *token != FAST_STRING)
+                return false;
+            tokenView name = parser->view;
+            if (next_token(parser) != FAST_EQ)
+                return false;
+            *token = next_token(parser);
+            if (*token != FAST_ID && *token != FAST_STRING)
+                return false;
+            *last = graph_builder_new_parameter(parser->builder, name, parser->view);
+            last = &(*last)->next;
+            *token = next_token(parser);
+            if (*token == FAST_COMMA)
+                *token = next_token(parser);
+            else if (*token == FAST_RBRACKET)
+                break;
+        }
+        *token = next_token(parser);
+    }
+    return true;
+}
+
+/**
+ * @brief Parses a node statement or a chain of edges starting with the identifier @p first.
+ * @param parser The parser.
+ * @param first The first identifier of the statement.
+ * @param token The token following the identifier, replaced by the token following the statement.
+ * @return true if the statement was correct.
+ */
+static bool parse_node_statement(fastParser *parser, tokenView first, fastToken *token)
+{
+    GraphBuilder *builder = parser->builder;
+    size_t length = 0;
+    parser->chain[length++] = graph_builder_add_node(builder, first.start, first.length);
+    while (*token == FAST_EDGEOP)
+    {
+        if (next_token(parser) != FAST_ID)
+            return false;
+        if (length == parser->chain_capacity)
+        {
+            parser->chain_capacity *= 2;
+            parser->chain = (int *)realloc(parser->chain, parser->chain_capacity * sizeof(int));
+        }
+        parser->chain[length++] = graph_builder_add_node(builder, parser->view.start, parser->view.length);
+        *token = next_token(parser);
+    }
+
+    parameterList *parameters = NULL;
+    if (*token == FAST_LBRACKET && !parse_attributes(parser, token, &parameters))
+        return false;
+
+    if (length == 1)
+    {
+        if (parameters != NULL)
+            graph_builder_add_node_parameters(builder, parser->chain[0], parameters);
+        return true;
+    }
+    // Same order as the actions of Parser.y: the end of the chain first, and the attributes only apply to its first edge.
+    for (size_t i = length - 1; i > 1; i--)
+        graph_builder_add_edge(builder, parser->chain[i - 1], parser->chain[i], NULL);
+    graph_builder_add_edge(builder, parser->chain[0], parser->chain[1], parameters);
+    return true;
+}
+
+/**
+ * @brief Parses the statements of the graph, after its left brace.
+ * @param parser The parser.
+ * @return true if the statements and the end of the buffer were correct.
+ */
+static bool parse_statements(fastParser *parser)
+{
+    fastToken token = next_token(parser);
+    while (token != FAST_RBRACE)
+    {
+        if (token != FAST_ID && token != FAST_STRING)
+            return false;
+        bool is_id = token == FAST_ID;
+        tokenView first = parser->view;
+        token = next_token(parser);
+        if (token == FAST_EQ)
+        {
+            // Assignment of an attribute of the graph: its strings are interned as by Parser.y, but it is ignored.
+            atom_intern_length(first.start, first.length);
+            token = next_token(parser);
+            if (token != FAST_ID && token != FAST_STRING)
+                return false;
+            view_atom(parser);
+            token = next_token(parser);
+        }
+        else if (!is_id || !parse_node_statement(parser, first, &token))
+            return false;
+        if (token == FAST_SEMI)
+            token = next_token(parser);
+    }
+    return next_token(parser) == FAST_END;
+}
+
+bool fast_parse(const char *buffer, size_t size, GraphBuilder *builder)
+{
+    fastParser parser;
+    parser.current = buffer;
+    parser.end = buffer + size;
+    parser.builder = builder;
+
+    fastToken token = next_token(&parser);
+    if (token == FAST_STRICT)
+        token = next_token(&parser);
+    if (token != FAST_DIGRAPH && token != FAST_GRAPH)
+        return false;
+    builder->directed = token == FAST_DIGRAPH;
+    token = next_token(&parser);
+    if (token != FAST_ID && token != FAST_STRING)
+        return false;
+    graph_builder_set_name(builder, parser.view.start, parser.view.length);
+    if (next_token(&parser) != FAST_LBRACE)
+        return false;
+
+    parser.chain_capacity = 16;
+    parser.chain = (int *)malloc(parser.chain_capacity * sizeof(int));
+    bool parsed = parse_statements(&parser);
+    free(parser.chain);
+    return parsed;
+}
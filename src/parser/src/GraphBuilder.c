@@ -0,0 +1,170 @@
+#include "GraphBuilder.h"
+#include "LabelDecoder.h"
+#include <stdlib.h>
+#include <string.h>
+
+void graph_builder_init(GraphBuilder *builder)
+{
+	builder->name = NULL;
+	initNodeList(&builder->nodes);
+	initEdgeList(&builder->edges);
+	builder->directed = false;
+	// Separate arenas, so that a copy modifying one part does not have to copy the others.
+	builder->structure_arena = arena_create();
+	builder->parameters_arena = arena_create();
+	builder->arena = arena_create();
+	builder->source_arena = NULL;
+}
+
+void graph_builder_set_source(GraphBuilder *builder, Arena source)
+{
+	builder->source_arena = arena_retain(source);
+}
+
+parameterList *graph_builder_new_parameter(GraphBuilder *builder, tokenView name, tokenView value)
+{
+	atom name_atom = atom_intern_length(name.start, name.length);
+	if (builder->source_arena != NULL)
+		return parameter_list_add_span(builder->arena, NULL, name_atom, value.start, value.length);
+	return parameter_list_add_atoms(builder->arena, NULL, name_atom, atom_intern_length(value.start, value.length));
+}
+
+void graph_builder_set_name(GraphBuilder *builder, const char *name, size_t length)
+{
+	builder->name = arena_strndup(builder->structure_arena, name, length);
+}
+
+int graph_builder_add_node(GraphBuilder *builder, const char *name, size_t length)
+{
+	return addOrUpdateNode(builder->structure_arena, name, length, &builder->nodes);
+}
+
+void graph_builder_add_node_parameters(GraphBuilder *builder, int node, parameterList *parameters)
+{
+	add_parameters_to_node(node, parameters, &builder->nodes);
+}
+
+void graph_builder_add_edge(GraphBuilder *builder, int source, int target, parameterList *parameters)
+{
+	addEdge(source, target, &builder->edges, parameters);
+}
+
+/**
+ * @brief Stores in a graph the masks of actions of its nodes, decoded from their labels, and its initial and final nodes (given by the shapes "square" and "invtriangle"), as a tunnel network would read them.
+ *
+ * @param graph The graph, whose node parameters are built.
+ */
+static void graph_builder_decode_actions(Graph *graph)
+{
+	atom shape = atom_intern("shape");
+	atom square = atom_intern("square");
+	atom invtriangle = atom_intern("invtriangle");
+	atom label = atom_intern("label");
+	labelDecoder decoder;
+	label_decoder_init(&decoder);
+
+	graph->node_actions = (int *)arena_alloc(graph->structure_arena, graph->numNodes * sizeof(int));
+	graph->initial = 0;
+	graph->final = 0;
+	for (int node = 0; node < graph->numNodes; node++)
+	{
+		atom node_shape = graph_get_node_attribute(*graph, node, shape);
+		if (node_shape == square)
+			graph->initial = node;
+		if (node_shape == invtriangle)
+			graph->final = node;
+		graph->node_actions[node] = label_decoder_actions(&decoder, graph_get_node_attribute(*graph, node, label));
+	}
+}
+
+void graph_builder_delete(GraphBuilder *builder)
+{
+	deleteNodeList(&builder->nodes);
+	deleteEdgeList(&builder->edges);
+	arena_release(builder->structure_arena);
+	arena_release(builder->parameters_arena);
+	arena_release(builder->arena);
+	if (builder->source_arena != NULL)
+		arena_release(builder->source_arena);
+}
+
+Graph graph_builder_finish(GraphBuilder *builder)
+{
+	Graph res;
+	res.structure_arena = builder->structure_arena;
+	res.parameters_arena = builder->parameters_arena;
+	res.source_arena = builder->source_arena;
+	res.name = builder->name;
+	res.numNodes = builder->nodes.size;
+	res.numEdges = 0;
+
+	// No matrix of edges: graph_is_edge reads the adjacency (or the edge bits).
+	res.edges = NULL;
+	res.nodes = (char **)arena_alloc(res.structure_arena, res.numNodes * sizeof(char *));
+
+	// Paramètres
+
+	parameterList **lists = (parameterList **)malloc(res.numNodes * sizeof(parameterList *));
+	res.edge_parameters.capacity = 0;
+	res.edge_parameters.size = 0;
+	res.edge_parameters.slots = NULL;
+	res.edge_parameters.arena = arena_create();
+
+	for (int node = 0; node < res.numNodes; node++)
+	{
+		// The names were allocated in the structure arena when the nodes were added.
+		res.nodes[node] = builder->nodes.nodes[node].node;
+		lists[node] = builder->nodes.nodes[node].parameters;
+	}
+
+	// The index built while parsing becomes the name index of the graph.
+	res.name_slots = takeNodeIndex(&builder->nodes, &res.name_slots_capacity);
+	arena_add_cleanup(res.structure_arena, free, res.name_slots);
+	graph_build_node_parameters(&res, lists);
+	free(lists);
+
+	size_t num_edge_statements = builder->edges.size;
+
+	// Edges, in both directions for undirected graphs, to build the adjacency index (which keeps repeated edges once).
+	int *sources = (int *)malloc((2 * num_edge_statements + 1) * sizeof(int));
+	int *targets = (int *)malloc((2 * num_edge_statements + 1) * sizeof(int));
+	size_t num_pairs = 0;
+
+	// Statements are processed from the last one, so that the first statement of a repeated edge gives its parameters.
+	for (size_t statement = num_edge_statements; statement-- > 0;)
+	{
+		SEdge *edge = &builder->edges.edges[statement];
+		int n1 = edge->node1;
+		int n2 = edge->node2;
+		sources[num_pairs] = n1;
+		targets[num_pairs] = n2;
+		num_pairs++;
+		graph_set_edge_parameter(&res, n1, n2, edge->parameters);
+		if (!builder->directed)
+		{
+			sources[num_pairs] = n2;
+			targets[num_pairs] = n1;
+			num_pairs++;
+			graph_set_edge_parameter(&res, n2, n1, edge->parameters);
+		}
+		res.numEdges++;
+	}
+	// The statements and their parameters are copied: they are freed before the adjacency is built, so that they do not add to its peak memory.
+	deleteNodeList(&builder->nodes);
+	deleteEdgeList(&builder->edges);
+	arena_release(builder->arena);
+
+	graph_build_adjacency(&res, sources, targets, num_pairs);
+	free(sources);
+	free(targets);
+
+	// Tunnel networks are directed: their actions are decoded once, here.
+	if (builder->directed)
+		graph_builder_decode_actions(&res);
+
+	// Colouring instances are undirected and often dense: their neighbourhoods are worth a bit-packed adjacency.
+	if (!builder->directed)
+		graph_build_edge_bits(&res);
+
+	return res;
+}
\ No newline at end of file
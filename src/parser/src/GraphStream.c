@@ -0,0 +1,274 @@
+#include "Parsing.h"
+#include "FastParser.h"
+#include <ctype.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief The number of characters read from the input at once.
+ */
+#define STREAM_READ_SIZE 65536
+
+/**
+ * @brief The number of graphs parsed in advance, waiting to be used.
+ */
+#define STREAM_QUEUE_SIZE 4
+
+/**
+ * @brief The state of the search of the end of a graph in a stream. Strings and comments are skipped, as they may contain braces.
+ */
+typedef struct
+{
+    int depth;       ///< The number of braces opened and not yet closed.
+    bool in_string;  ///< Whether a string is being read.
+    bool escaped;    ///< Whether the previous character of the string is an escaping backslash.
+    bool in_comment; ///< Whether a comment is being read.
+    bool slash;      ///< Whether the previous character is a slash (outside of strings and comments).
+    bool started;    ///< Whether something else than spaces and comments was read since the previous graph.
+} graphSplitter;
+
+struct graphStream_s
+{
+    FILE *input;                       ///< The file read.
+    pthread_t reader;                  ///< The thread reading and parsing the file.
+    Graph graphs[STREAM_QUEUE_SIZE];   ///< The graphs parsed, in a circular buffer.
+    int first;                         ///< The position of the first graph in the buffer.
+    int count;                         ///< The number of graphs in the buffer.
+    bool finished;                     ///< Whether the reader reached the end of the file.
+    bool closing;                      ///< Whether the stream is being closed.
+    pthread_mutex_t mutex;             ///< Protects the buffer and the flags.
+    pthread_cond_t not_empty;          ///< Signalled when a graph is added, or the reader finishes.
+    pthread_cond_t not_full;           ///< Signalled when a graph is removed, or the stream is closed.
+};
+
+/**
+ * @brief Searches the end of the current graph in a text.
+ *
+ * @param splitter The state of the search, kept from one call to the next.
+ * @param text The text read.
+ * @param position The position from which to search. Set to the position following the closing brace of the graph if it is found, or to @p size otherwise.
+ * @param size The size of the text.
+ * @return true if the end of the graph was found.
+ */
+static bool find_graph_end(graphSplitter *splitter, const char *text, size_t *position, size_t size)
+{
+    for (; *position < size; (*position)++)
+    {
+        char c = text[*position];
+        if (splitter->in_comment)
+        {
+            splitter->in_comment = c != '\n';
+            continue;
+        }
+        if (splitter->in_string)
+        {
+            if (splitter->escaped)
+                splitter->escaped = false;
+            else if (c == '\\')
+                splitter->escaped = true;
+            else if (c == '"')
+                splitter->in_string = false;
+            continue;
+        }
+        if (c == '/')
+        {
+            splitter->in_comment = splitter->slash;
+            splitter->slash = !splitter->slash;
+            continue;
+        }
+        if (splitter->slash)
+            splitter->started = true;
+        splitter->slash = false;
+        if (isspace((unsigned char)c))
+            continue;
+        splitter->started = true;
+        if (c == '"')
+            splitter->in_string = true;
+        else if (c == '{')
+            splitter->depth++;
+        // A stray closing brace ends the graph too, so that the parser reports it.
+        else if (c == '}' && --splitter->depth <= 0)
+        {
+            (*position)++;
+            memset(splitter, 0, sizeof(graphSplitter));
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Parses a graph, with the fast parser if possible and with bison otherwise.
+ *
+ * @param text The text of the graph, followed by two characters which are temporarily replaced by null characters.
+ * @param size The size of the text.
+ * @param graph The address where the graph is stored.
+ * @return true if the graph was parsed without error.
+ */
+static bool parse_graph(char *text, size_t size, Graph *graph)
+{
+    char saved[2] = {text[size], text[size + 1]};
+    text[size] = text[size + 1] = '\0';
+
+    GraphBuilder builder;
+    graph_builder_init(&builder);
+    bool parsed = fast_parse(text, size, &builder);
+    if (!parsed)
+    {
+        graph_builder_delete(&builder);
+        graph_builder_init(&builder);
+        parsed = parse_buffer(text, size, &builder);
+    }
+
+    text[size] = saved[0];
+    text[size + 1] = saved[1];
+
+    if (!parsed)
+    {
+        graph_builder_delete(&builder);
+        return false;
+    }
+    *graph = graph_builder_finish(&builder);
+    return true;
+}
+
+/**
+ * @brief Adds a graph to a stream, waiting for some room in its buffer.
+ *
+ * @param stream The stream.
+ * @param graph The graph.
+ * @return false if the stream is being closed (the graph is then deleted).
+ */
+static bool push_graph(graphStream *stream, Graph graph)
+{
+    pthread_mutex_lock(&stream->mutex);
+    while (stream->count == STREAM_QUEUE_SIZE && !stream->closing)
+        pthread_cond_wait(&stream->not_full, &stream->mutex);
+    if (stream->closing)
+    {
+        pthread_mutex_unlock(&stream->mutex);
+        graph_delete(graph);
+        return false;
+    }
+    stream->graphs[(stream->first + stream->count) % STREAM_QUEUE_SIZE] = graph;
+    stream->count++;
+    pthread_cond_signal(&stream->not_empty);
+    pthread_mutex_unlock(&stream->mutex);
+    return true;
+}
+
+/**
+ * @brief Reads the input of a stream and parses each graph as soon as it is complete.
+ *        The text is read in a buffer, from which each complete graph is parsed in place, before the remainder is moved to its beginning.
+ *
+ * @param data The graphStream.
+ * @return void* NULL.
+ */
+static void *read_graphs(void *data)
+{
+    graphStream *stream = (graphStream *)data;
+    graphSplitter splitter;
+    memset(&splitter, 0, sizeof(graphSplitter));
+    // Two characters are always available after the text, for the parser.
+    size_t capacity = STREAM_READ_SIZE + 2;
+    char *buffer = (char *)malloc(capacity);
+    size_t size = 0;
+    size_t scanned = 0;
+    int num_graphs = 0;
+
+    for (;;)
+    {
+        size_t start = 0;
+        while (find_graph_end(&splitter, buffer, &scanned, size))
+        {
+            Graph graph;
+            num_graphs++;
+            if (!parse_graph(buffer + start, scanned - start, &graph))
+                printf("Graph %d of the stream could not be parsed, skipped.\n", num_graphs);
+            else if (!push_graph(stream, graph))
+                goto end;
+            start = scanned;
+        }
+        memmove(buffer, buffer + start, size - start);
+        size -= start;
+        scanned -= start;
+
+        if (size + STREAM_READ_SIZE + 2 > capacity)
+        {
+            capacity *= 2;
+            buffer = (char *)realloc(buffer, capacity);
+        }
+        size_t read = fread(buffer + size, 1, STREAM_READ_SIZE, stream->input);
+        if (read == 0)
+            break;
+        size += read;
+    }
+
+    if (splitter.started)
+        printf("The end of the stream does not contain a complete graph, ignored.\n");
+
+end:
+    free(buffer);
+    pthread_mutex_lock(&stream->mutex);
+    stream->finished = true;
+    pthread_cond_signal(&stream->not_empty);
+    pthread_mutex_unlock(&stream->mutex);
+    return NULL;
+}
+
+graphStream *graph_stream_open(FILE *input)
+{
+    graphStream *stream = (graphStream *)malloc(sizeof(graphStream));
+    stream->input = input;
+    stream->first = 0;
+    stream->count = 0;
+    stream->finished = false;
+    stream->closing = false;
+    pthread_mutex_init(&stream->mutex, NULL);
+    pthread_cond_init(&stream->not_empty, NULL);
+    pthread_cond_init(&stream->not_full, NULL);
+    if (pthread_create(&stream->reader, NULL, read_graphs, stream) != 0)
+    {
+        pthread_cond_destroy(&stream->not_full);
+        pthread_cond_destroy(&stream->not_empty);
+        pthread_mutex_destroy(&stream->mutex);
+        free(stream);
+        return NULL;
+    }
+    return stream;
+}
+
+bool graph_stream_next(graphStream *stream, Graph *graph)
+{
+    pthread_mutex_lock(&stream->mutex);
+    while (stream->count == 0 && !stream->finished)
+        pthread_cond_wait(&stream->not_empty, &stream->mutex);
+    if (stream->count == 0)
+    {
+        pthread_mutex_unlock(&stream->mutex);
+        return false;
+    }
+    *graph = stream->graphs[stream->first];
+    stream->first = (stream->first + 1) % STREAM_QUEUE_SIZE;
+    stream->count--;
+    pthread_cond_signal(&stream->not_full);
+    pthread_mutex_unlock(&stream->mutex);
+    return true;
+}
+
+void graph_stream_close(graphStream *stream)
+{
+    pthread_mutex_lock(&stream->mutex);
+    stream->closing = true;
+    pthread_cond_signal(&stream->not_full);
+    pthread_mutex_unlock(&stream->mutex);
+    pthread_join(stream->reader, NULL);
+
+    for (int i = 0; i < stream->count; i++)
+        graph_delete(stream->graphs[(stream->first + i) % STREAM_QUEUE_SIZE]);
+    pthread_cond_destroy(&stream->not_full);
+    pthread_cond_destroy(&stream->not_empty);
+    pthread_mutex_destroy(&stream->mutex);
+    free(stream);
+}
@@ -0,0 +1,101 @@
+#include "LabelDecoder.h"
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * @brief The UTF-8 encodings of the arrows of the actions.
+ */
+#define RIGHT_ARROW "\xe2\x86\x92" // →
+#define UP_ARROW "\xe2\x86\x91"    // ↑
+#define DOWN_ARROW "\xe2\x86\x93"  // ↓
+
+/**
+ * @brief Whether a character separates the tokens of a label. These are the characters of the separator "\n" and the quotes around the label.
+ */
+static inline bool is_separator(char c)
+{
+    return c == '\\' || c == 'n' || c == '"';
+}
+
+/**
+ * @brief Returns the index of the stack size (4 or 6) written by a character.
+ *
+ * @param c A character.
+ * @return int 0 for '4', 1 for '6', -1 otherwise.
+ */
+static inline int stack_index(char c)
+{
+    return c == '4' ? 0 : (c == '6' ? 1 : -1);
+}
+
+/**
+ * @brief Decodes a token of a label.
+ *
+ * @param token The token.
+ * @param length Its length.
+ * @return int The index of the action of the token, or -1 if it is not an action.
+ */
+static int decode_token(const char *token, size_t length)
+{
+    // x→x
+    if (length == 5 && memcmp(token + 1, RIGHT_ARROW, 3) == 0 && token[4] == token[0])
+        return stack_index(token[0]);
+    if (length != 6)
+        return -1;
+    // x↑xy: push y on x.
+    if (memcmp(token + 1, UP_ARROW, 3) == 0 && token[4] == token[0])
+    {
+        int top = stack_index(token[0]);
+        int pushed = stack_index(token[5]);
+        return top < 0 || pushed < 0 ? -1 : 2 + 2 * top + pushed;
+    }
+    // xy↓x: pop y from x.
+    if (memcmp(token + 2, DOWN_ARROW, 3) == 0 && token[5] == token[0])
+    {
+        int top = stack_index(token[0]);
+        int popped = stack_index(token[1]);
+        return top < 0 || popped < 0 ? -1 : 6 + 2 * top + popped;
+    }
+    return -1;
+}
+
+int label_decode_actions(const char *label, size_t length)
+{
+    int actions = 0;
+    size_t position = 0;
+    while (position < length)
+    {
+        if (is_separator(label[position]))
+        {
+            position++;
+            continue;
+        }
+        size_t start = position;
+        while (position < length && !is_separator(label[position]))
+            position++;
+        int action = decode_token(label + start, position - start);
+        if (action >= 0)
+            actions |= 1 << action;
+    }
+    return actions;
+}
+
+void label_decoder_init(labelDecoder *decoder)
+{
+    for (int i = 0; i < LABEL_CACHE_SIZE; i++)
+        decoder->labels[i] = NO_ATOM;
+}
+
+int label_decoder_actions(labelDecoder *decoder, atom label)
+{
+    if (label == NO_ATOM)
+        return 0;
+    int slot = label % LABEL_CACHE_SIZE;
+    if (decoder->labels[slot] != label)
+    {
+        char *string = atom_string(label);
+        decoder->labels[slot] = label;
+        decoder->actions[slot] = label_decode_actions(string, strlen(string));
+    }
+    return decoder->actions[slot];
+}
@@ -3,8 +3,8 @@
  * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
  * @brief  Structure to store a list of graph nodes that can be dynamically modified. Used as a temporary structure during parsing before translating into a more static structure.
  *         Includes automata features (initial and final nodes).
- * @version 1
- * @date 2019-07-22
+ * @version 3
+ * @date 2019-07-22, 2026-10-15
  *
  * @copyright Creative Commons.
  *
@@ -17,107 +17,102 @@
 #include <string.h>
 
 /**
- * @brief Allocates space for node list
- * @return The expression or NULL if not enough memory
+ * @brief Finds the slot of the node named n, or the free slot where it should be inserted.
+ * @param n the name (need not be null-terminated)
+ * @param length its length
+ * @param list the list of nodes (with at least one free slot)
+ * @return the index of the slot
  */
-static SNodeList *allocateNodeList()
+static size_t findSlot(const char *n, size_t length, SNodeList *list)
 {
-    SNodeList *b = (SNodeList *)malloc(sizeof(SNodeList));
-
-    if (b == NULL)
-        return NULL;
-
-    b->node = NULL;
-
-    b->next = NULL;
-
-    b->parameters = NULL;
-
-    return b;
+    size_t slot = graph_name_slot(n, length, list->num_slots);
+    while (list->slots[slot] != -1)
+    {
+        SNode *node = &list->nodes[list->slots[slot]];
+        if (node->length == length && memcmp(node->node, n, length) == 0)
+            break;
+        slot = (slot + 1) & (list->num_slots - 1);
+    }
+    return slot;
 }
 
-SNodeList *addNode(char *n1, SNodeList *list)
+/**
+ * @brief Doubles the number of slots of the index (or creates it), and reinserts the nodes.
+ * @param list the list of nodes
+ */
+static void growSlots(SNodeList *list)
 {
-    SNodeList *b = allocateNodeList();
-
-    if (b == NULL)
-        return NULL;
-
-    b->node = (char *)malloc((strlen(n1) + 1) * sizeof(char));
-    strcpy(b->node, n1);
-
-    b->next = list;
+    free(list->slots);
+    list->num_slots = list->num_slots == 0 ? 64 : 2 * list->num_slots;
+    list->slots = (int *)malloc(list->num_slots * sizeof(int));
+    for (size_t i = 0; i < list->num_slots; i++)
+        list->slots[i] = -1;
+    for (int node = 0; node < list->size; node++)
+        list->slots[findSlot(list->nodes[node].node, list->nodes[node].length, list)] = node;
+}
 
-    return b;
+void initNodeList(SNodeList *list)
+{
+    list->nodes = NULL;
+    list->size = 0;
+    list->capacity = 0;
+    list->slots = NULL;
+    list->num_slots = 0;
 }
 
-void addOrUpdateNode(char *n, SNodeList *list)
+int addOrUpdateNode(Arena arena, const char *n, size_t length, SNodeList *list)
 {
-    if (list == NULL)
-    {
-        return;
-    }
+    if (2 * ((size_t)list->size + 1) > list->num_slots)
+        growSlots(list);
+    size_t slot = findSlot(n, length, list);
+    if (list->slots[slot] != -1)
+        return list->slots[slot];
 
-    if (strcmp(list->node, n) != 0)
+    if (list->size == list->capacity)
     {
-        if (list->next == NULL)
-            list->next = addNode(n, NULL);
-        else
-            addOrUpdateNode(n, list->next);
-        return;
+        list->capacity = list->capacity == 0 ? 64 : 2 * list->capacity;
+        list->nodes = (SNode *)realloc(list->nodes, list->capacity * sizeof(SNode));
     }
-    return;
+    list->nodes[list->size].node = arena_strndup(arena, n, length);
+    list->nodes[list->size].length = length;
+    list->nodes[list->size].parameters = NULL;
+    list->slots[slot] = list->size;
+    return list->size++;
 }
 
-void add_parameters_to_node(char *node, parameterList *parameters, SNodeList *list)
+int findNodeInList(const char *n, SNodeList *list)
 {
-    if (list == NULL)
-        return;
-    if (strcmp(node, list->node) != 0)
-    {
-        add_parameters_to_node(node, parameters, list->next);
-        return;
-    }
-    list->parameters = parameter_lists_merge(list->parameters, parameters);
+    if (list->num_slots == 0)
+        return -1;
+    return list->slots[findSlot(n, strlen(n), list)];
 }
 
-void printNodeList(SNodeList *e)
+int *takeNodeIndex(SNodeList *list, size_t *num_slots)
 {
-    if (e == NULL)
-    {
-        printf("\n");
-        return;
-    }
-    printf("%s\n", e->node);
-    printNodeList(e->next);
+    if (list->num_slots == 0)
+        growSlots(list);
+    int *slots = list->slots;
+    *num_slots = list->num_slots;
+    list->slots = NULL;
+    list->num_slots = 0;
+    return slots;
 }
 
-void deleteNodeList(SNodeList *b)
+void add_parameters_to_node(int node, parameterList *parameters, SNodeList *list)
 {
-    if (b == NULL)
-        return;
-
-    deleteNodeList(b->next);
-
-    free(b->node);
-
-    parameter_list_delete(b->parameters);
+    list->nodes[node].parameters = parameter_lists_merge(list->nodes[node].parameters, parameters);
+}
 
-    free(b);
+void printNodeList(SNodeList *e)
+{
+    for (int node = 0; node < e->size; node++)
+        printf("%s\n", e->nodes[node].node);
+    printf("\n");
 }
 
-/* Testing main.
-int main (void){
-    SNodeList *toto = NULL;
-    toto = addNode("coucou",true,false,toto);
-    toto = addNode("voilà",false,false,toto);
-    addOrUpdateNode("coucou",false,true,toto);
-    addOrUpdateNode("Hey",false,false,toto);
-    SNodeList *arg = toto;
-    while(arg!=NULL){
-        printf("%s,%d,%d\n",arg->node,arg->initial,arg->final);
-        arg=arg->next;
-    }
-    deleteNodeList(toto);
+void deleteNodeList(SNodeList *b)
+{
+    free(b->nodes);
+    free(b->slots);
+    initNodeList(b);
 }
-*/
@@ -1,100 +1,403 @@
 #include "Parsing.h"
 #include "Parser.h"
 #include "Lexer.h"
-#include "GraphListToGraph.h"
+#include "GraphBuilder.h"
+#include "FastParser.h"
+#include "Snapshot.h"
+#include "CompressedInput.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <setjmp.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-int yyparse(GraphList *expression, yyscan_t scanner);
+int yyparse(GraphBuilder *builder, yyscan_t scanner);
 
 /**
- * @brief Parses a string and return the GraphList described by it.
+ * @brief Compressed files larger than this (in bytes) are decompressed on a separate thread, while the scanner reads what was already decompressed.
+ */
+#define COMPRESSED_THREAD_THRESHOLD (1 << 20)
+
+/**
+ * @brief Runs the parser on the current buffer of a scanner. A fatal error of the scanner jumps back here, so that the parse is abandoned instead of exiting the program.
+ * 
+ * @param scanner A scanner, whose extra data is @p state.
+ * @param state The state of the scanner.
+ * @param builder The builder fed by the parser.
+ * @return true if the parse succeeded.
+ */
+static bool run_parser(yyscan_t scanner, scannerState *state, GraphBuilder *builder)
+{
+    if (setjmp(state->on_error) != 0)
+        return false;
+    return yyparse(builder, scanner) == 0;
+}
+
+/**
+ * @brief Parses a string and return the Graph described by it.
  * 
  * @param expr A string in graphviz format.
- * @return GraphList The parsed GraphList.
+ * @return Graph The parsed Graph.
  */
-GraphList getGraphList(const char *expr)
+Graph getGraph(const char *expr)
 {
-    GraphList expression;
+    GraphBuilder builder;
+    scannerState state;
     yyscan_t scanner;
-    YY_BUFFER_STATE state;
 
-    expression.nodes = NULL;
-    expression.edges = NULL;
+    graph_builder_init(&builder);
+    // The string is copied by the scanner, and outlives the parse.
+    state.tokens = NULL;
+    state.input = NULL;
 
-    if (yylex_init(&scanner))
+    if (yylex_init_extra(&state, &scanner))
     {
         /* could not initialize */
         printf("Error initialization\n");
-        return expression;
+        return graph_builder_finish(&builder);
     }
 
-    state = yy_scan_string(expr, scanner);
+    YY_BUFFER_STATE buffer = yy_scan_string(expr, scanner);
 
-    if (yyparse(&expression, scanner))
+    if (!run_parser(scanner, &state, &builder))
     {
         /* error parsing */
         printf("Error parsing\n");
-        return expression;
     }
 
-    yy_delete_buffer(state, scanner);
+    yy_delete_buffer(buffer, scanner);
 
     yylex_destroy(scanner);
 
-    return expression;
+    return graph_builder_finish(&builder);
 }
 
 /**
- * @brief Parses a file and return the GraphList described by it.
+ * @brief Parses a file and return the Graph described by it.
  * 
  * @param toRead A file in graphviz format.
- * @return GraphList The parsed GraphList.
+ * @return Graph The parsed Graph.
  */
-GraphList getGraphListFromFile(FILE *toRead)
+Graph getGraphFromFile(FILE *toRead)
 {
-    GraphList expression;
+    GraphBuilder builder;
+    scannerState state;
     yyscan_t scanner;
-    YY_BUFFER_STATE state;
 
-    expression.nodes = NULL;
-    expression.edges = NULL;
+    graph_builder_init(&builder);
+    // The buffer is refilled during the scan: tokens are copied in the arena of the builder.
+    state.tokens = builder.arena;
+    state.input = NULL;
 
-    if (yylex_init(&scanner))
+    if (yylex_init_extra(&state, &scanner))
     {
         /* could not initialize */
         printf("Error initialization\n");
-        return expression;
+        fclose(toRead);
+        return graph_builder_finish(&builder);
     }
 
-    state = yy_create_buffer(toRead, YY_BUF_SIZE, scanner);
-    yy_switch_to_buffer(state, scanner);
+    YY_BUFFER_STATE buffer = yy_create_buffer(toRead, YY_BUF_SIZE, scanner);
+    yy_switch_to_buffer(buffer, scanner);
 
-    if (yyparse(&expression, scanner))
+    if (!run_parser(scanner, &state, &builder))
     {
         /* error parsing */
         printf("Error parsing\n");
-        return expression;
     }
 
-    yy_delete_buffer(state, scanner);
+    yy_delete_buffer(buffer, scanner);
 
     yylex_destroy(scanner);
 
     fclose(toRead);
 
-    return expression;
+    return graph_builder_finish(&builder);
+}
+
+/**
+ * @brief Parses a compressed file, streamed to the scanner through a decompressor (without temporary file).
+ * 
+ * @param toRead The name of the file, for error messages.
+ * @param fd The file, opened for reading. It is closed.
+ * @param format Its compression format.
+ * @param size Its size, to choose whether the decompression runs on a thread of its own.
+ * @param graph The address where the graph is stored.
+ * @return true if the file was read.
+ * @return false if the compression format is not supported by this build, or the data is corrupted (an error message is displayed).
+ */
+static bool get_graph_from_compressed_file(char *toRead, int fd, compressionFormat format, off_t size, Graph *graph)
+{
+    compressedInput *input = compressed_input_open(fd, format, size > COMPRESSED_THREAD_THRESHOLD);
+    if (input == NULL)
+    {
+        printf("file %s is compressed with %s, which this build cannot read.\n", toRead, compression_name(format));
+        close(fd);
+        return false;
+    }
+
+    GraphBuilder builder;
+    scannerState state;
+    yyscan_t scanner;
+
+    graph_builder_init(&builder);
+    // The buffer is refilled during the scan: tokens are copied in the arena of the builder.
+    state.tokens = builder.arena;
+    state.input = input;
+
+    if (yylex_init_extra(&state, &scanner))
+    {
+        /* could not initialize */
+        printf("Error initialization\n");
+        compressed_input_close(input);
+        graph_builder_delete(&builder);
+        return false;
+    }
+
+    // The scanner reads the decompressed characters through YY_INPUT, and never uses the FILE.
+    YY_BUFFER_STATE buffer = yy_create_buffer(NULL, YY_BUF_SIZE, scanner);
+    yy_switch_to_buffer(buffer, scanner);
+
+    if (!run_parser(scanner, &state, &builder))
+    {
+        /* error parsing */
+        printf("Error parsing\n");
+    }
+
+    yy_delete_buffer(buffer, scanner);
+
+    yylex_destroy(scanner);
+
+    if (!compressed_input_close(input))
+    {
+        printf("file %s: corrupted or truncated %s data.\n", toRead, compression_name(format));
+        graph_builder_delete(&builder);
+        return false;
+    }
+    *graph = graph_builder_finish(&builder);
+    return true;
+}
+
+/**
+ * @brief Maps a file in memory, followed by the two null characters flex expects at the end of a buffer scanned in place.
+ *        An anonymous area of the whole size is reserved first, and the file is mapped privately over its beginning, so that the characters after the end of the file are zeros.
+ *        The mapping is writable, as the scanner temporarily writes a null character after each token.
+ * 
+ * @param fd A file descriptor opened for reading.
+ * @param size The size of the file (positive).
+ * @return char* The mapping (of size @p size + 2), or NULL if the file could not be mapped.
+ */
+static char *map_source(int fd, size_t size)
+{
+    char *buffer = (char *)mmap(NULL, size + 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer == MAP_FAILED)
+        return NULL;
+    if (mmap(buffer, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+        munmap(buffer, size + 2);
+        return NULL;
+    }
+    return buffer;
+}
+
+bool parse_buffer(char *buffer, size_t size, GraphBuilder *builder)
+{
+    scannerState state;
+    yyscan_t scanner;
+
+    // The buffer outlives the parse: tokens are used in place.
+    state.tokens = NULL;
+    state.input = NULL;
+
+    if (yylex_init_extra(&state, &scanner))
+    {
+        /* could not initialize */
+        printf("Error initialization\n");
+        return false;
+    }
+
+    YY_BUFFER_STATE buffer_state = yy_scan_buffer(buffer, size + 2, scanner);
+
+    bool parsed = run_parser(scanner, &state, builder);
+    if (!parsed)
+    {
+        /* error parsing */
+        printf("Error parsing\n");
+    }
+
+    yy_delete_buffer(buffer_state, scanner);
+
+    yylex_destroy(scanner);
+
+    return parsed;
+}
+
+/**
+ * @brief Whether the values of parameters of mapped files are kept as spans of the file (see set_lazy_attributes).
+ */
+static bool lazy_attributes = false;
+
+void set_lazy_attributes(bool lazy)
+{
+    lazy_attributes = lazy;
+}
+
+/**
+ * @brief A mapped source, unmapped when the arena holding it is freed.
+ */
+typedef struct
+{
+    char *address; ///< The mapping.
+    size_t length; ///< Its length.
+} sourceMapping;
+
+/**
+ * @brief Unmaps a source (cleanup function of an arena).
+ * 
+ * @param data A sourceMapping.
+ */
+static void unmap_source(void *data)
+{
+    sourceMapping *mapping = (sourceMapping *)data;
+    munmap(mapping->address, mapping->length);
+}
+
+bool try_get_graph_from_file(char *toRead, Graph *graph)
+{
+    int fd = open(toRead, O_RDONLY);
+    if (fd == -1)
+    {
+        printf("file %s does not exist.\n", toRead);
+        return false;
+    }
+
+    struct stat status;
+    char *buffer = NULL;
+    if (fstat(fd, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0)
+    {
+        unsigned char header[4];
+        ssize_t header_size = pread(fd, header, sizeof(header), 0);
+        compressionFormat format = compression_detect(header, header_size < 0 ? 0 : header_size);
+        if (format != compression_none)
+            return get_graph_from_compressed_file(toRead, fd, format, status.st_size, graph);
+        buffer = map_source(fd, status.st_size);
+    }
+    if (buffer == NULL)
+    {
+        *graph = getGraphFromFile(fdopen(fd, "r"));
+        return true;
+    }
+    close(fd);
+
+    // With lazy attributes, the mapping lives as long as the graph, whose parameter values refer to it.
+    Arena source = NULL;
+    if (lazy_attributes)
+    {
+        source = arena_create();
+        sourceMapping *mapping = (sourceMapping *)arena_alloc(source, sizeof(sourceMapping));
+        mapping->address = buffer;
+        mapping->length = status.st_size + 2;
+        arena_add_cleanup(source, unmap_source, mapping);
+    }
+
+    // The fast parser handles the usual instances, and gives up on the rest, which is then parsed by bison.
+    GraphBuilder builder;
+    graph_builder_init(&builder);
+    if (source != NULL)
+        graph_builder_set_source(&builder, source);
+    if (!fast_parse(buffer, status.st_size, &builder))
+    {
+        graph_builder_delete(&builder);
+        graph_builder_init(&builder);
+        if (source != NULL)
+            graph_builder_set_source(&builder, source);
+        parse_buffer(buffer, status.st_size, &builder);
+    }
+    *graph = graph_builder_finish(&builder);
+    if (source != NULL)
+        arena_release(source);
+    else
+        munmap(buffer, status.st_size + 2);
+    return true;
 }
 
 Graph get_graph_from_file(char *toRead)
 {
-    FILE *file = fopen(toRead, "r");
-    if (file == NULL)
+    Graph graph;
+    if (!try_get_graph_from_file(toRead, &graph))
     {
-        printf("file %s does not exist. Exiting.\n", toRead);
+        printf("Exiting.\n");
         exit(-1);
     }
-    GraphList e = getGraphListFromFile(file);
-    Graph graph = createGraph(e);
-    deleteExpression(e.edges);
-    deleteNodeList(e.nodes);
     return graph;
 }
+
+/**
+ * @brief The work shared by the threads loading files.
+ */
+typedef struct
+{
+    char **files;          ///< The names of the files.
+    Graph *graphs;         ///< Where the graphs are stored.
+    bool *loaded;          ///< Whether each file was loaded.
+    int num_files;         ///< The number of files.
+    int next;              ///< The next file to load.
+    pthread_mutex_t mutex; ///< Protects next.
+} loadingQueue;
+
+/**
+ * @brief Loads files of a loading queue until it is empty.
+ * 
+ * @param data The loadingQueue.
+ * @return void* NULL.
+ */
+static void *load_files(void *data)
+{
+    loadingQueue *queue = (loadingQueue *)data;
+    for (;;)
+    {
+        pthread_mutex_lock(&queue->mutex);
+        int file = queue->next++;
+        pthread_mutex_unlock(&queue->mutex);
+        if (file >= queue->num_files)
+            return NULL;
+        if (snapshot_detect(queue->files[file]))
+            queue->loaded[file] = snapshot_try_load(queue->files[file], &queue->graphs[file]);
+        else
+            queue->loaded[file] = try_get_graph_from_file(queue->files[file], &queue->graphs[file]);
+    }
+}
+
+bool get_graphs_from_files(char **files, int num_files, Graph *graphs, int num_threads)
+{
+    loadingQueue queue;
+    queue.files = files;
+    queue.graphs = graphs;
+    queue.loaded = (bool *)malloc(num_files * sizeof(bool));
+    queue.num_files = num_files;
+    queue.next = 0;
+    pthread_mutex_init(&queue.mutex, NULL);
+
+    if (num_threads > num_files)
+        num_threads = num_files;
+    pthread_t threads[num_threads > 1 ? num_threads - 1 : 1];
+    int num_started = 0;
+    // The calling thread loads files too.
+    while (num_started < num_threads - 1 && pthread_create(&threads[num_started], NULL, load_files, &queue) == 0)
+        num_started++;
+    load_files(&queue);
+    for (int i = 0; i < num_started; i++)
+        pthread_join(threads[i], NULL);
+    pthread_mutex_destroy(&queue.mutex);
+
+    bool all_loaded = true;
+    for (int file = 0; file < num_files; file++)
+        all_loaded = all_loaded && queue.loaded[file];
+    if (!all_loaded)
+        for (int file = 0; file < num_files; file++)
+            if (queue.loaded[file])
+                graph_delete(graphs[file]);
+    free(queue.loaded);
+    return all_loaded;
+}
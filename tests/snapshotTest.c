@@ -0,0 +1,213 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <Graph.h>
+#include <Parsing.h>
+#include <Snapshot.h>
+
+/**
+ * @brief The values written over each word of a snapshot to corrupt it.
+ */
+static const int32_t corruptions[] = {1000000, -1, -2, INT32_MAX, INT32_MIN, 1};
+#define NUM_CORRUPTIONS (int)(sizeof(corruptions) / sizeof(corruptions[0]))
+
+/**
+ * @brief Writes @p size bytes in the file @p path.
+ *
+ * @return true if the file was written.
+ */
+bool write_file(const char *path, const char *data, size_t size)
+{
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+        return false;
+    bool written = fwrite(data, 1, size, file) == size;
+    return fclose(file) == 0 && written;
+}
+
+/**
+ * @brief Reads the whole file @p path.
+ *
+ * @param size Where its size is stored.
+ * @return char* Its content (to free), or NULL.
+ */
+char *read_file(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+        return NULL;
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *data = (char *)malloc(*size);
+    if (fread(data, 1, *size, file) != *size)
+    {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    return data;
+}
+
+/**
+ * @brief Tells if every index of a loaded graph is within bounds, by reading all of it.
+ *
+ * @param graph A graph loaded from a snapshot.
+ * @return char* What is out of bounds, or NULL.
+ */
+char *check_graph(Graph graph)
+{
+    int num_nodes = graph_num_nodes(graph);
+    if (graph_get_initial(graph) < -1 || graph_get_initial(graph) >= num_nodes || graph_get_final(graph) < -1 || graph_get_final(graph) >= num_nodes)
+        return "initial or final node";
+    for (int node = 0; node < num_nodes; node++)
+    {
+        const int *neighbours;
+        size_t degree = graph_out_neighbours(graph, node, &neighbours);
+        for (size_t i = 0; i < degree; i++)
+            if (neighbours[i] < 0 || neighbours[i] >= num_nodes || !graph_is_edge(graph, node, neighbours[i]))
+                return "successor";
+        degree = graph_in_neighbours(graph, node, &neighbours);
+        for (size_t i = 0; i < degree; i++)
+            if (neighbours[i] < 0 || neighbours[i] >= num_nodes)
+                return "predecessor";
+        // A corrupted name index within bounds can only make a lookup miss, as a corrupted name does.
+        int found = graph_find_node(graph, graph_get_node_name(graph, node));
+        if (found < -1 || found >= num_nodes)
+            return "name";
+        for (parameterList *param = graph_get_node_parameter(graph, node); param != NULL; param = param->next)
+            if (strlen(param->name) + strlen(param->value) == (size_t)-1)
+                return "parameter";
+    }
+    return NULL;
+}
+
+/**
+ * @brief Checks that a snapshot of @p path loads back identically, and that the loader rejects or safely loads every corruption of it (with AddressSanitizer, an access out of bounds aborts the test).
+ *
+ * @param path A .dot file.
+ * @return int The number of failures.
+ */
+int test_file(char *path)
+{
+    Graph graph;
+    if (!try_get_graph_from_file(path, &graph))
+    {
+        printf("FAIL %s: cannot be parsed\n", path);
+        return 1;
+    }
+    graph_build_edge_bits(&graph);
+    char snapshot[] = "/tmp/snapshotTestXXXXXX";
+    int descriptor = mkstemp(snapshot);
+    if (descriptor == -1 || !snapshot_write(graph, snapshot))
+    {
+        printf("FAIL %s: cannot write a snapshot\n", path);
+        graph_delete(graph);
+        return 1;
+    }
+    close(descriptor);
+
+    int failures = 0;
+    Graph loaded;
+    if (!snapshot_try_load(snapshot, &loaded))
+    {
+        printf("FAIL %s: its snapshot does not load\n", path);
+        failures++;
+    }
+    else
+    {
+        bool same = graph_num_nodes(loaded) == graph_num_nodes(graph) && check_graph(loaded) == NULL;
+        for (int node = 0; same && node < graph_num_nodes(graph); node++)
+        {
+            same = strcmp(graph_get_node_name(loaded, node), graph_get_node_name(graph, node)) == 0 && graph_find_node(loaded, graph_get_node_name(graph, node)) == node;
+            for (int target = 0; same && target < graph_num_nodes(graph); target++)
+                same = graph_is_edge(loaded, node, target) == graph_is_edge(graph, node, target);
+        }
+        if (!same)
+        {
+            printf("FAIL %s: its snapshot loads a different graph\n", path);
+            failures++;
+        }
+        graph_delete(loaded);
+    }
+
+    size_t size;
+    char *content = read_file(snapshot, &size);
+    char corrupted[] = "/tmp/snapshotTestXXXXXX";
+    descriptor = mkstemp(corrupted);
+    close(descriptor);
+    int num_rejected = 0;
+    int num_loaded = 0;
+    // The loader reports each invalid snapshot on the standard output.
+    fflush(stdout);
+    int saved_stdout = dup(STDOUT_FILENO);
+    int null_output = open("/dev/null", O_WRONLY);
+    dup2(null_output, STDOUT_FILENO);
+    close(null_output);
+
+    // Every word after the magic number is overwritten in turn with each corruption.
+    for (size_t offset = 8; content != NULL && offset + sizeof(int32_t) <= size; offset += sizeof(int32_t))
+    {
+        for (int corruption = 0; corruption < NUM_CORRUPTIONS; corruption++)
+        {
+            int32_t original;
+            memcpy(&original, content + offset, sizeof(int32_t));
+            memcpy(content + offset, &corruptions[corruption], sizeof(int32_t));
+            bool written = write_file(corrupted, content, size);
+            memcpy(content + offset, &original, sizeof(int32_t));
+            if (!written)
+                continue;
+            if (!snapshot_try_load(corrupted, &loaded))
+            {
+                num_rejected++;
+                continue;
+            }
+            num_loaded++;
+            char *error = check_graph(loaded);
+            graph_delete(loaded);
+            if (error != NULL)
+            {
+                dprintf(saved_stdout, "FAIL %s: %s out of bounds accepted with %d at offset %zu\n", path, error, corruptions[corruption], offset);
+                failures++;
+            }
+        }
+    }
+    // Truncated snapshots are rejected.
+    for (size_t length = 0; content != NULL && length < size; length += 1 + size / 64)
+    {
+        if (write_file(corrupted, content, length) && snapshot_try_load(corrupted, &loaded))
+        {
+            graph_delete(loaded);
+            dprintf(saved_stdout, "FAIL %s: snapshot truncated to %zu bytes accepted\n", path, length);
+            failures++;
+        }
+    }
+
+    fflush(stdout);
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+    printf("%s: %d corruptions rejected, %d loaded safely\n", path, num_rejected, num_loaded);
+    free(content);
+    unlink(corrupted);
+    unlink(snapshot);
+    graph_delete(graph);
+    return failures;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        printf("Usage: snapshotTest file...\n");
+        printf(" Writes a snapshot of each .dot file, checks that it loads back, and that every corruption of one of its words is either rejected or loaded within bounds.\n");
+        return EXIT_FAILURE;
+    }
+    int failures = 0;
+    for (int i = 1; i < argc; i++)
+        failures += test_file(argv[i]);
+    printf(failures == 0 ? "snapshot tests passed\n" : "%d snapshot tests failed\n", failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}